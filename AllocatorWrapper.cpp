@@ -1,110 +1,255 @@
-#include "AllocatorWrapper.hpp"
+#include "AllocatorWrapper.inline.hpp"
 #include "ZAllocators.hpp"
-
-template<class A>
-AllocatorWrapper<A>::AllocatorWrapper(void* initial_pool, size_t pool_size, int lazyThreshold, bool startFull) 
-    : allocator(initial_pool, pool_size, lazyThreshold, startFull) {}
-
-template<class A>
-void AllocatorWrapper<A>::reset() {
-    allocator.reset();
-}
-
-template<class A>
-void *AllocatorWrapper<A>::allocate(size_t size) {
-    return allocator.allocate(size);
-}
-
-template<class A>
-void AllocatorWrapper<A>::free(void* ptr) {
-    allocator.free(ptr,0);
-}
-
-template<class A>
-void AllocatorWrapper<A>::free(void* ptr, size_t block_size) {
-    allocator.free(ptr, block_size);
-}
-
-template<class A>
-void AllocatorWrapper<A>::free_range(void* start_ptr, size_t block_size) {
-    allocator.free_range(start_ptr, block_size);
-}
-
-template<class A>
-void AllocatorWrapper<A>::aggregate() {
-    allocator.aggregate();
-}
-
-template<class A>
-AllocatorWrapper<A>::~AllocatorWrapper(){}
+#include "utilities/debug.hpp"
 
 template class AllocatorWrapper<ZTLSFAllocator>;
 // template class AllocatorWrapper<ZBuddyAllocator>;
 template class AllocatorWrapper<ZinaryBuddyAllocator>;
+template class AllocatorWrapper<ZMediumBuddyAllocator>;
+template class AllocatorWrapper<ZGapBumpAllocator>;
 
 
 
-ZAllocatorWrapper::ZAllocatorWrapper(void* initial_pool, size_t pool_size, int lazyThreshold, bool startFull, bool useBinaryBuddyAllocator) 
-  : useBinaryBuddyAllocator(useBinaryBuddyAllocator) {
-    if(useBinaryBuddyAllocator) {
-      binaryBuddyAllocator = new AllocatorWrapper<ZinaryBuddyAllocator>(initial_pool, pool_size, lazyThreshold, startFull);
-    } else {
+ZAllocatorWrapper::ZAllocatorWrapper(void* initial_pool, size_t pool_size, int lazyThreshold, bool startFull, ZFreeListAllocatorKind kind) 
+  : tlsfAllocator(nullptr),
+    binaryBuddyAllocator(nullptr),
+    mediumBinaryBuddyAllocator(nullptr),
+    gapBumpAllocator(nullptr),
+    kind(kind) {
+    switch(kind) {
+    case ZFreeListAllocatorKind::tlsf:
       tlsfAllocator = new AllocatorWrapper<ZTLSFAllocator>(initial_pool, pool_size, lazyThreshold, startFull);
+      break;
+    case ZFreeListAllocatorKind::binary_buddy:
+      binaryBuddyAllocator = new AllocatorWrapper<ZinaryBuddyAllocator>(initial_pool, pool_size, lazyThreshold, startFull);
+      break;
+    case ZFreeListAllocatorKind::medium_binary_buddy:
+      mediumBinaryBuddyAllocator = new AllocatorWrapper<ZMediumBuddyAllocator>(initial_pool, pool_size, lazyThreshold, startFull);
+      break;
+    case ZFreeListAllocatorKind::gap_bump:
+      gapBumpAllocator = new AllocatorWrapper<ZGapBumpAllocator>(initial_pool, pool_size, lazyThreshold, startFull);
+      break;
     }
 }
 
+ZFreeListAllocatorKind ZAllocatorWrapper::allocator_kind() const {
+  return kind;
+}
+
 void ZAllocatorWrapper::reset() {
-  if(useBinaryBuddyAllocator) {
-    binaryBuddyAllocator->reset();
-  } else {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
     tlsfAllocator->reset();
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->reset();
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->reset();
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->reset();
+    break;
   }
 }
 
 void *ZAllocatorWrapper::allocate(size_t size) {
-  if(useBinaryBuddyAllocator) {
-    return binaryBuddyAllocator->allocate(size);
-  } else {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
     return tlsfAllocator->allocate(size);
+  case ZFreeListAllocatorKind::binary_buddy:
+    return binaryBuddyAllocator->allocate(size);
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    return mediumBinaryBuddyAllocator->allocate(size);
+  case ZFreeListAllocatorKind::gap_bump:
+    return gapBumpAllocator->allocate(size);
+  }
+  ShouldNotReachHere();
+  return nullptr;
+}
+
+size_t ZAllocatorWrapper::allocate_many(const size_t* sizes, void** out, size_t count) {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    return tlsfAllocator->allocate_many(sizes, out, count);
+  case ZFreeListAllocatorKind::binary_buddy:
+    return binaryBuddyAllocator->allocate_many(sizes, out, count);
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    return mediumBinaryBuddyAllocator->allocate_many(sizes, out, count);
+  case ZFreeListAllocatorKind::gap_bump:
+    return gapBumpAllocator->allocate_many(sizes, out, count);
   }
+  ShouldNotReachHere();
+  return 0;
 }
 
 void ZAllocatorWrapper::free(void *ptr) {
-  if(useBinaryBuddyAllocator) {
-    binaryBuddyAllocator->free(ptr);
-  } else {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
     tlsfAllocator->free(ptr);
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->free(ptr);
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->free(ptr);
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->free(ptr);
+    break;
   }
 }
 
 void ZAllocatorWrapper::free(void *ptr, size_t block_size) {
-  if(useBinaryBuddyAllocator) {
-    binaryBuddyAllocator->free(ptr, block_size);
-  } else {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
     tlsfAllocator->free(ptr, block_size);
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->free(ptr, block_size);
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->free(ptr, block_size);
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->free(ptr, block_size);
+    break;
   }
 }
 
 void ZAllocatorWrapper::free_range(void *start_ptr, size_t size) {
-  if(useBinaryBuddyAllocator) {
-    binaryBuddyAllocator->free_range(start_ptr, size);
-  } else {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
     tlsfAllocator->free_range(start_ptr, size);
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->free_range(start_ptr, size);
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->free_range(start_ptr, size);
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->free_range(start_ptr, size);
+    break;
+  }
+}
+
+void ZAllocatorWrapper::free_ranges(const FreeRange *ranges, size_t count) {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    tlsfAllocator->free_ranges(ranges, count);
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->free_ranges(ranges, count);
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->free_ranges(ranges, count);
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->free_ranges(ranges, count);
+    break;
   }
 }
 
 void ZAllocatorWrapper::aggregate() {
-  if(useBinaryBuddyAllocator) {
-    binaryBuddyAllocator->aggregate();
-  } else {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
     tlsfAllocator->aggregate();
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->aggregate();
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->aggregate();
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->aggregate();
+    break;
   }
 }
 
-ZAllocatorWrapper::~ZAllocatorWrapper() {
-  if(useBinaryBuddyAllocator) {
-    delete binaryBuddyAllocator;
-  } else {
-    delete tlsfAllocator;
+void ZAllocatorWrapper::rebase(void *start, size_t size) {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    tlsfAllocator->rebase(start, size);
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->rebase(start, size);
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->rebase(start, size);
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->rebase(start, size);
+    break;
+  }
+}
+
+size_t ZAllocatorWrapper::largest_free_block() {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    return tlsfAllocator->largest_free_block();
+  case ZFreeListAllocatorKind::binary_buddy:
+    return binaryBuddyAllocator->largest_free_block();
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    return mediumBinaryBuddyAllocator->largest_free_block();
+  case ZFreeListAllocatorKind::gap_bump:
+    return gapBumpAllocator->largest_free_block();
+  }
+  ShouldNotReachHere();
+  return 0;
+}
+
+size_t ZAllocatorWrapper::metadata_size() {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    return sizeof(*this) + tlsfAllocator->metadata_size();
+  case ZFreeListAllocatorKind::binary_buddy:
+    return sizeof(*this) + binaryBuddyAllocator->metadata_size();
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    return sizeof(*this) + mediumBinaryBuddyAllocator->metadata_size();
+  case ZFreeListAllocatorKind::gap_bump:
+    return sizeof(*this) + gapBumpAllocator->metadata_size();
+  }
+  ShouldNotReachHere();
+  return 0;
+}
+
+size_t ZAllocatorWrapper::free_granularity() {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    return tlsfAllocator->free_granularity();
+  case ZFreeListAllocatorKind::binary_buddy:
+    return binaryBuddyAllocator->free_granularity();
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    return mediumBinaryBuddyAllocator->free_granularity();
+  case ZFreeListAllocatorKind::gap_bump:
+    return gapBumpAllocator->free_granularity();
   }
+  ShouldNotReachHere();
+  return 0;
+}
+
+void ZAllocatorWrapper::free_blocks_do(void (*do_block)(void* ctx, void* start, size_t size), void* ctx) {
+  switch(kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    tlsfAllocator->free_blocks_do(do_block, ctx);
+    break;
+  case ZFreeListAllocatorKind::binary_buddy:
+    binaryBuddyAllocator->free_blocks_do(do_block, ctx);
+    break;
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    mediumBinaryBuddyAllocator->free_blocks_do(do_block, ctx);
+    break;
+  case ZFreeListAllocatorKind::gap_bump:
+    gapBumpAllocator->free_blocks_do(do_block, ctx);
+    break;
+  }
+}
+
+ZAllocatorWrapper::~ZAllocatorWrapper() {
+  delete tlsfAllocator;
+  delete binaryBuddyAllocator;
+  delete mediumBinaryBuddyAllocator;
+  delete gapBumpAllocator;
 }
\ No newline at end of file
@@ -6,6 +6,16 @@
 
 // #include ""
 
+// The free list allocator used by a recycled page
+enum class ZFreeListAllocatorKind {
+  tlsf,
+  binary_buddy,
+  medium_binary_buddy,
+  gap_bump
+};
+
+const uint ZFreeListAllocatorKindCount = 4;
+
 template<class A>
 class AllocatorWrapper : public CHeapObj<mtGC>{
 private:
@@ -14,26 +24,49 @@ public:
   AllocatorWrapper(void* initial_pool, size_t pool_size, int lazyThreshold, bool startFull);
   void reset();
   void *allocate(size_t size);
+  size_t allocate_many(const size_t* sizes, void** out, size_t count);
   void free(void *ptr);
   void free(void *ptr, size_t block_size);
   void free_range(void *start_ptr, size_t size);
+  void free_ranges(const FreeRange* ranges, size_t count);
   void aggregate();
+  void rebase(void* start, size_t size);
+  size_t largest_free_block();
+  size_t metadata_size();
+  size_t free_granularity();
+  void free_blocks_do(void (*do_block)(void* ctx, void* start, size_t size), void* ctx);
   ~AllocatorWrapper();
 };
 
 class ZAllocatorWrapper : public CHeapObj<mtGC>{
 private:
-  AllocatorWrapper<ZTLSFAllocator>*       tlsfAllocator;
-  AllocatorWrapper<ZinaryBuddyAllocator>* binaryBuddyAllocator;
-  bool useBinaryBuddyAllocator;
+  AllocatorWrapper<ZTLSFAllocator>*        tlsfAllocator;
+  AllocatorWrapper<ZinaryBuddyAllocator>*  binaryBuddyAllocator;
+  AllocatorWrapper<ZMediumBuddyAllocator>* mediumBinaryBuddyAllocator;
+  AllocatorWrapper<ZGapBumpAllocator>*     gapBumpAllocator;
+  ZFreeListAllocatorKind kind;
 public:
-  ZAllocatorWrapper(void* initial_pool, size_t pool_size, int lazyThreshold, bool startFull, bool useBinaryBuddyAllocator);
+  ZAllocatorWrapper(void* initial_pool, size_t pool_size, int lazyThreshold, bool startFull, ZFreeListAllocatorKind kind);
+  ZFreeListAllocatorKind allocator_kind() const;
+  // The typed allocator, for callers that know the kind. Calls through it
+  // are not dispatched on the kind, see AllocatorWrapper.inline.hpp.
+  template<class A> AllocatorWrapper<A>* as();
   void reset();
   void *allocate(size_t size);
+  // Allocates count blocks in order, and returns how many were allocated
+  size_t allocate_many(const size_t* sizes, void** out, size_t count);
   void free(void *ptr);
   void free(void *ptr, size_t block_size);
   void free_range(void *start_ptr, size_t size);
+  void free_ranges(const FreeRange* ranges, size_t count);
   void aggregate();
+  void rebase(void* start, size_t size);
+  size_t largest_free_block();
+  size_t metadata_size();
+  // Freed ranges are only guaranteed to be offered at this granularity
+  size_t free_granularity();
+  // Calls do_block for every free block. Not thread-safe.
+  void free_blocks_do(void (*do_block)(void* ctx, void* start, size_t size), void* ctx);
   ~ZAllocatorWrapper();
 };
 
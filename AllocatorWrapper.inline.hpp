@@ -0,0 +1,108 @@
+#ifndef ALLOCATOR_WRAPPER_INLINE
+#define ALLOCATOR_WRAPPER_INLINE
+
+#include "gc/z/AllocatorWrapper.hpp"
+
+#include "gc/z/ZAllocators.hpp"
+#include "utilities/debug.hpp"
+
+// The typed wrapper is defined inline, so that code which knows the kind of
+// the free list allocator calls the allocator directly, see as<A>().
+
+template<class A>
+inline AllocatorWrapper<A>::AllocatorWrapper(void* initial_pool, size_t pool_size, int lazyThreshold, bool startFull) 
+    : allocator(initial_pool, pool_size, lazyThreshold, startFull) {}
+
+template<class A>
+inline void AllocatorWrapper<A>::reset() {
+    allocator.reset();
+}
+
+template<class A>
+inline void *AllocatorWrapper<A>::allocate(size_t size) {
+    return allocator.allocate(size);
+}
+
+template<class A>
+inline size_t AllocatorWrapper<A>::allocate_many(const size_t* sizes, void** out, size_t count) {
+    return allocator.allocate_many(sizes, out, count);
+}
+
+template<class A>
+inline void AllocatorWrapper<A>::free(void* ptr) {
+    allocator.free(ptr,0);
+}
+
+template<class A>
+inline void AllocatorWrapper<A>::free(void* ptr, size_t block_size) {
+    allocator.free(ptr, block_size);
+}
+
+template<class A>
+inline void AllocatorWrapper<A>::free_range(void* start_ptr, size_t block_size) {
+    allocator.free_range(start_ptr, block_size);
+}
+
+template<class A>
+inline void AllocatorWrapper<A>::free_ranges(const FreeRange* ranges, size_t count) {
+    allocator.free_ranges(ranges, count);
+}
+
+template<class A>
+inline void AllocatorWrapper<A>::aggregate() {
+    allocator.aggregate();
+}
+
+template<class A>
+inline void AllocatorWrapper<A>::rebase(void* start, size_t size) {
+    allocator.rebase(start, size);
+}
+
+template<class A>
+inline size_t AllocatorWrapper<A>::largest_free_block() {
+    return allocator.largest_free_block();
+}
+
+template<class A>
+inline size_t AllocatorWrapper<A>::metadata_size() {
+    return sizeof(*this) - sizeof(allocator) + allocator.metadata_size();
+}
+
+template<class A>
+inline size_t AllocatorWrapper<A>::free_granularity() {
+    return allocator.free_granularity();
+}
+
+template<class A>
+inline void AllocatorWrapper<A>::free_blocks_do(void (*do_block)(void* ctx, void* start, size_t size), void* ctx) {
+    allocator.free_blocks_do(do_block, ctx);
+}
+
+template<class A>
+inline AllocatorWrapper<A>::~AllocatorWrapper(){}
+
+template<>
+inline AllocatorWrapper<ZTLSFAllocator>* ZAllocatorWrapper::as<ZTLSFAllocator>() {
+  assert(kind == ZFreeListAllocatorKind::tlsf, "Wrong allocator kind");
+  return tlsfAllocator;
+}
+
+template<>
+inline AllocatorWrapper<ZinaryBuddyAllocator>* ZAllocatorWrapper::as<ZinaryBuddyAllocator>() {
+  assert(kind == ZFreeListAllocatorKind::binary_buddy, "Wrong allocator kind");
+  return binaryBuddyAllocator;
+}
+
+template<>
+inline AllocatorWrapper<ZMediumBuddyAllocator>* ZAllocatorWrapper::as<ZMediumBuddyAllocator>() {
+  assert(kind == ZFreeListAllocatorKind::medium_binary_buddy, "Wrong allocator kind");
+  return mediumBinaryBuddyAllocator;
+}
+
+template<>
+inline AllocatorWrapper<ZGapBumpAllocator>* ZAllocatorWrapper::as<ZGapBumpAllocator>() {
+  assert(kind == ZFreeListAllocatorKind::gap_bump, "Wrong allocator kind");
+  return gapBumpAllocator;
+}
+
+#endif
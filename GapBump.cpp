@@ -0,0 +1,238 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "GapBump.hpp"
+
+GapBumpAllocator::GapBumpAllocator(void *start, size_t size)
+    : _start((uintptr_t)start), _size(size), _gaps(nullptr), _ngaps(0),
+      _capacity(0), _cursor(0), _largest(0) {
+  assert(size <= UINT32_MAX && "Gaps are stored as 32-bit offsets");
+}
+
+GapBumpAllocator::~GapBumpAllocator() { release_gaps(); }
+
+uint32_t *GapBumpAllocator::allocate_gaps(size_t count) {
+  return (uint32_t *)malloc(count * sizeof(uint32_t));
+}
+
+void GapBumpAllocator::free_gaps(uint32_t *gaps, size_t count) { ::free(gaps); }
+
+void GapBumpAllocator::release_gaps() {
+  if (_gaps != nullptr) {
+    free_gaps(_gaps, 2 * _capacity);
+    _gaps = nullptr;
+  }
+  _ngaps = 0;
+  _capacity = 0;
+  _cursor = 0;
+  _largest = 0;
+}
+
+void GapBumpAllocator::fill() {
+  _ngaps = 0;
+  _cursor = 0;
+  _largest = 0;
+}
+
+void GapBumpAllocator::rebase(void *start, size_t size) {
+  assert(size <= UINT32_MAX && "Gaps are stored as 32-bit offsets");
+  _start = (uintptr_t)start;
+  _size = size;
+  fill();
+}
+
+size_t GapBumpAllocator::gap_size(size_t gap) const {
+  return _gaps[2 * gap + 1] - _gaps[2 * gap];
+}
+
+void GapBumpAllocator::advance_cursor() {
+  while (_cursor < _ngaps && gap_size(_cursor) == 0) {
+    _cursor++;
+  }
+}
+
+void GapBumpAllocator::ensure_capacity(size_t count) {
+  if (count <= _capacity) {
+    return;
+  }
+
+  size_t capacity = _capacity == 0 ? _initial_capacity : _capacity;
+  while (capacity < count) {
+    capacity *= 2;
+  }
+
+  uint32_t *const gaps = allocate_gaps(2 * capacity);
+  if (_ngaps > 0) {
+    memcpy(gaps, _gaps, 2 * _ngaps * sizeof(uint32_t));
+  }
+  if (_gaps != nullptr) {
+    free_gaps(_gaps, 2 * _capacity);
+  }
+
+  _gaps = gaps;
+  _capacity = capacity;
+}
+
+void GapBumpAllocator::insert_gap(size_t gap, uint32_t from, uint32_t to) {
+  ensure_capacity(_ngaps + 1);
+  memmove(&_gaps[2 * (gap + 1)], &_gaps[2 * gap],
+          2 * (_ngaps - gap) * sizeof(uint32_t));
+  _gaps[2 * gap] = from;
+  _gaps[2 * gap + 1] = to;
+  _ngaps++;
+}
+
+size_t GapBumpAllocator::find_gap(uint32_t offset) const {
+  // Index of the first gap that starts at or after offset
+  size_t low = 0;
+  size_t high = _ngaps;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (_gaps[2 * mid] < offset) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+void *GapBumpAllocator::allocate(size_t size) {
+  size = (size + _alignment - 1) & ~(_alignment - 1);
+  if (size > _largest) {
+    // No gap is large enough
+    return nullptr;
+  }
+
+  size_t largest = 0;
+  for (size_t gap = _cursor; gap < _ngaps; gap++) {
+    const size_t available = gap_size(gap);
+    if (available >= size) {
+      const uintptr_t addr = _start + _gaps[2 * gap];
+      _gaps[2 * gap] += (uint32_t)size;
+      if (gap == _cursor) {
+        advance_cursor();
+      }
+      return (void *)addr;
+    }
+
+    if (available > largest) {
+      largest = available;
+    }
+  }
+
+  // All gaps after the cursor were visited, so the bound is now exact
+  _largest = largest;
+  return nullptr;
+}
+
+void GapBumpAllocator::deallocate_range(void *ptr, size_t size) {
+  if (size == 0) {
+    return;
+  }
+
+  assert((uintptr_t)ptr >= _start && (uintptr_t)ptr + size <= _start + _size &&
+         "Range outside of the pool");
+  const uint32_t from = (uint32_t)((uintptr_t)ptr - _start);
+  const uint32_t to = (uint32_t)(from + size);
+
+  size_t gap;
+  if (_ngaps == 0 || from >= _gaps[2 * (_ngaps - 1) + 1]) {
+    // Ranges are usually returned in address order
+    gap = _ngaps;
+  } else {
+    gap = find_gap(from);
+  }
+
+  if (gap > 0 && _gaps[2 * (gap - 1) + 1] == from) {
+    // Coalesce with the preceding gap
+    gap--;
+    _gaps[2 * gap + 1] = to;
+
+    if (gap + 1 < _ngaps && _gaps[2 * (gap + 1)] == to) {
+      // Coalesce with the following gap as well
+      _gaps[2 * gap + 1] = _gaps[2 * (gap + 1) + 1];
+      memmove(&_gaps[2 * (gap + 1)], &_gaps[2 * (gap + 2)],
+              2 * (_ngaps - gap - 2) * sizeof(uint32_t));
+      _ngaps--;
+      if (_cursor > gap + 1) {
+        _cursor--;
+      }
+    }
+  } else if (gap < _ngaps && _gaps[2 * gap] == to) {
+    // Coalesce with the following gap, typically when the last
+    // allocation from that gap is undone
+    _gaps[2 * gap] = from;
+  } else {
+    insert_gap(gap, from, to);
+  }
+
+  if (gap < _cursor) {
+    _cursor = gap;
+  }
+
+  const size_t coalesced = gap_size(gap);
+  if (coalesced > _largest) {
+    _largest = coalesced;
+  }
+}
+
+void GapBumpAllocator::coalesce() {
+  size_t ngaps = 0;
+  size_t largest = 0;
+
+  for (size_t gap = 0; gap < _ngaps; gap++) {
+    const uint32_t from = _gaps[2 * gap];
+    const uint32_t to = _gaps[2 * gap + 1];
+    if (from == to) {
+      // Used up
+      continue;
+    }
+
+    if (ngaps > 0 && _gaps[2 * (ngaps - 1) + 1] == from) {
+      _gaps[2 * (ngaps - 1) + 1] = to;
+    } else {
+      _gaps[2 * ngaps] = from;
+      _gaps[2 * ngaps + 1] = to;
+      ngaps++;
+    }
+
+    const size_t size = gap_size(ngaps - 1);
+    if (size > largest) {
+      largest = size;
+    }
+  }
+
+  _ngaps = ngaps;
+  _cursor = 0;
+  _largest = largest;
+}
+
+size_t GapBumpAllocator::largest_free_block() {
+  size_t largest = 0;
+  for (size_t gap = _cursor; gap < _ngaps; gap++) {
+    const size_t size = gap_size(gap);
+    if (size > largest) {
+      largest = size;
+    }
+  }
+
+  _largest = largest;
+  return largest;
+}
+
+void GapBumpAllocator::free_blocks_do(
+    void (*do_block)(void *ctx, void *start, size_t size), void *ctx) {
+  for (size_t gap = 0; gap < _ngaps; gap++) {
+    const size_t size = gap_size(gap);
+    if (size > 0) {
+      do_block(ctx, (void *)(_start + _gaps[2 * gap]), size);
+    }
+  }
+}
+
+size_t GapBumpAllocator::metadata_size() {
+  return sizeof(*this) + 2 * _capacity * sizeof(uint32_t);
+}
@@ -0,0 +1,82 @@
+#ifndef GAPBUMP_HPP
+#define GAPBUMP_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// A bump pointer allocator for the gaps between live objects.
+//
+// The free memory is kept as a vector of gaps, sorted by address, instead of
+// segregated free-lists. Allocations bump within the gap at the cursor, and
+// skip ahead to the first gap that fits when the object does not fit the
+// current gap. Since objects are relocated in address order, most gaps are
+// filled front to back and there is no per-block metadata to maintain.
+//
+// The allocator is not thread-safe. It must only be used by one thread at a
+// time.
+class GapBumpAllocator {
+public:
+  // The allocator starts with the entire pool allocated.
+  GapBumpAllocator(void *start, size_t size);
+  virtual ~GapBumpAllocator();
+  GapBumpAllocator(const GapBumpAllocator &) = delete;
+  GapBumpAllocator &operator=(const GapBumpAllocator &) = delete;
+
+  // Marks the entire pool as allocated.
+  void fill();
+
+  void *allocate(size_t size);
+
+  // Returns a range to the allocator. Ranges that are returned in address
+  // order are appended to the gap vector, other ranges are inserted in place
+  // and coalesced with an adjacent gap.
+  void deallocate_range(void *ptr, size_t size);
+
+  // Coalesces adjacent gaps and drops the gaps that have been used up.
+  void coalesce();
+
+  // Moves the allocator to a new pool and marks all of it as allocated.
+  void rebase(void *start, size_t size);
+
+  // Size of the largest gap at or after the cursor, or 0 if there is none.
+  size_t largest_free_block();
+
+  // Calls do_block for every non-empty gap, in address order.
+  void free_blocks_do(void (*do_block)(void *ctx, void *start, size_t size),
+                      void *ctx);
+
+  size_t metadata_size();
+
+protected:
+  // The gap vector is allocated through these, so that a subclass can
+  // account for it. A subclass that overrides them must call release_gaps()
+  // from its destructor.
+  virtual uint32_t *allocate_gaps(size_t count);
+  virtual void free_gaps(uint32_t *gaps, size_t count);
+
+  void release_gaps();
+
+private:
+  static const size_t _alignment = 8;
+  static const size_t _initial_capacity = 64;
+
+  uintptr_t _start;
+  size_t _size;
+
+  // Gap i covers [_start + _gaps[2 * i], _start + _gaps[2 * i + 1])
+  uint32_t *_gaps;
+  size_t _ngaps;
+  size_t _capacity;
+  size_t _cursor;
+
+  // Upper bound of the largest gap at or after the cursor
+  size_t _largest;
+
+  size_t gap_size(size_t gap) const;
+  void advance_cursor();
+  void ensure_capacity(size_t count);
+  void insert_gap(size_t gap, uint32_t from, uint32_t to);
+  size_t find_gap(uint32_t offset) const;
+};
+
+#endif // GAPBUMP_HPP
@@ -96,8 +96,8 @@ void *JSMallocBase<Config>::allocate(size_t size) {
 
   size_t allocated_size = blk->get_size();
 
-  _internal_fragmentation = allocated_size - size;
-  _allocated += allocated_size;
+  _internal_fragmentation.fetch_add(allocated_size - size, std::memory_order_relaxed);
+  _allocated.fetch_add(allocated_size, std::memory_order_relaxed);
 
   // Make sure addresses are aligned to the word-size (8-bytes).
   // TODO: This might not be necessary if everything is already aligned, and
@@ -107,9 +107,65 @@ void *JSMallocBase<Config>::allocate(size_t size) {
   return (void *)blk_start;
 }
 
+template<typename Config>
+size_t JSMallocBase<Config>::allocate_many(const size_t *sizes, void **out, size_t count) {
+  if(_block_header_length == 0 && count > 1) {
+    // The blocks of the batch are adjacent, so the free-lists only have to
+    // be searched once
+    size_t total_size = 0;
+    for(size_t i = 0; i < count; i++) {
+      total_size += align_size(sizes[i]);
+    }
+
+    BlockHeader *blk = find_block(total_size);
+    if(blk != nullptr) {
+      size_t allocated_size = blk->get_size();
+
+      _internal_fragmentation.fetch_add(allocated_size - total_size, std::memory_order_relaxed);
+      _allocated.fetch_add(allocated_size, std::memory_order_relaxed);
+
+      uintptr_t blk_start = (uintptr_t)blk;
+      for(size_t i = 0; i < count; i++) {
+        out[i] = (void *)blk_start;
+        blk_start += align_size(sizes[i]);
+      }
+
+      return count;
+    }
+  }
+
+  // Allocate the blocks one by one, until an allocation fails
+  size_t allocated = 0;
+  while(allocated < count) {
+    out[allocated] = allocate(sizes[allocated]);
+    if(out[allocated] == nullptr) {
+      break;
+    }
+    allocated++;
+  }
+
+  return allocated;
+}
+
 template<typename Config>
 double JSMallocBase<Config>::internal_fragmentation() {
-  return (double)_internal_fragmentation / _allocated;
+  return (double)_internal_fragmentation.load(std::memory_order_relaxed) / _allocated.load(std::memory_order_relaxed);
+}
+
+template<typename Config>
+void JSMallocBase<Config>::free_blocks_do(void (*do_block)(void *ctx, void *start, size_t size), void *ctx) {
+  for(size_t i = 0; i <= _num_lists; i++) {
+    BlockHeader *current = _blocks[i].load();
+    if(!Config::UseSecondLevels && current != nullptr) {
+      // The head is stored as a versioned offset
+      current = reinterpret_cast<BlockHeader *>(JSMallocUtil::from_offset(_block_start, false, reinterpret_cast<uint64_t>(current)));
+    }
+
+    while(current != nullptr) {
+      do_block(ctx, (void *)((uintptr_t)current + _block_header_length), current->get_size());
+      current = blk_get_next(current);
+    }
+  }
 }
 
 template<typename Config>
@@ -574,7 +630,9 @@ void JSMallocBase<ZOptimizedConfig>::insert_block(BlockHeader *blk) {
 
     blk_set_next(blk, reinterpret_cast<BlockHeader *>(JSMallocUtil::from_offset(_block_start, false, reinterpret_cast<uint64_t>(offset))));
 
-    uint64_t version = 1;
+    // Every update of the head bumps the version, so that a concurrent
+    // remove_block that read an old head cannot succeed (ABA).
+    uint64_t version = (uint32_t)(JSMallocUtil::get_bits(reinterpret_cast<uint64_t>(head), true) + 1);
     new_head = reinterpret_cast<BlockHeader *>(version);
     JSMallocUtil::set_offset(false, calculate_offset(blk, _block_start), reinterpret_cast<uint64_t *>(&new_head));
   } while(!_blocks[flat_mapping].compare_exchange_strong(head, new_head));
@@ -599,11 +657,27 @@ BlockHeader *JSMallocBase<ZOptimizedConfig>::remove_block(BlockHeader *target_bl
   uint32_t version = JSMallocUtil::get_bits(head_bits, true);
   BlockHeader *actual_head = reinterpret_cast<BlockHeader *>(JSMallocUtil::from_offset(_block_start, false, head_bits));
 
-  BlockHeader *next_blk = (actual_head == nullptr)
-    ? nullptr
-    : blk_get_next(actual_head);
+  // Clears the bitmap bit of an empty free-list. A block might be inserted
+  // before the bit is cleared, in which case the bit is set again so that
+  // the block can be found.
+  auto clear_bitmap_if_empty = [&]() {
+    _fl_bitmap.fetch_and(~(1UL << mapping.fl));
+    if(JSMallocUtil::from_offset(_block_start, false, reinterpret_cast<uint64_t>(_blocks[flat_mapping].load())) != nullptr) {
+      _fl_bitmap.fetch_or(1UL << mapping.fl);
+    }
+  };
+
+  if(actual_head == nullptr) {
+    // The free-list is empty, but the bitmap said otherwise
+    clear_bitmap_if_empty();
+    return nullptr;
+  }
+
+  // The head might be removed and reused concurrently, in which case next_blk
+  // is garbage, but then the version has changed and the CAS below fails.
+  BlockHeader *next_blk = blk_get_next(actual_head);
 
-  BlockHeader *new_head = reinterpret_cast<BlockHeader *>(version + 1);
+  BlockHeader *new_head = reinterpret_cast<BlockHeader *>((uint64_t)(uint32_t)(version + 1));
   JSMallocUtil::set_offset(false, calculate_offset(next_blk, _block_start), reinterpret_cast<uint64_t *>(&new_head));
 
   if(!_blocks[flat_mapping].compare_exchange_strong(head, new_head)) {
@@ -611,7 +685,7 @@ BlockHeader *JSMallocBase<ZOptimizedConfig>::remove_block(BlockHeader *target_bl
   }
 
   if(next_blk == nullptr) {
-    _fl_bitmap.fetch_and(~(1UL << mapping.fl));
+    clear_bitmap_if_empty();
   }
 
   return actual_head;
@@ -640,17 +714,176 @@ void JSMallocZ::free_range(void *start_ptr, size_t size) {
   free(start_ptr, size);
 }
 
-void JSMallocZ::aggregate() {
-  BlockHeader *current_blk = reinterpret_cast<BlockHeader *>(_block_start);
+void JSMallocZ::free_ranges(const FreeRange *ranges, size_t count) {
+  BlockHeader *first[_num_lists + 1] = {nullptr};
+  BlockHeader *last[_num_lists + 1] = {nullptr};
+  uint64_t fl_bitmap = 0;
+
+  // Chain the blocks belonging to the same free-list
+  for(size_t i = 0; i < count; i++) {
+    if(ranges[i].start == nullptr || !ptr_in_pool((uintptr_t)ranges[i].start)) {
+      continue;
+    }
+
+    BlockHeader *blk = reinterpret_cast<BlockHeader *>(ranges[i].start);
+    blk->size = ranges[i].size;
+    blk->mark_free();
 
-  while(current_blk != nullptr) {
-    BlockHeader *next_blk = get_next_phys_block(current_blk);
+    Mapping mapping = get_mapping(blk->get_size());
+    uint32_t flat_mapping = flatten_mapping(mapping);
+
+    if(first[flat_mapping] == nullptr) {
+      last[flat_mapping] = blk;
+    }
+    blk_set_next(blk, first[flat_mapping]);
+    first[flat_mapping] = blk;
+
+    fl_bitmap |= 1UL << mapping.fl;
+  }
+
+  for(uint32_t flat_mapping = 0; flat_mapping <= _num_lists; flat_mapping++) {
+    if(first[flat_mapping] != nullptr) {
+      insert_blocks(first[flat_mapping], last[flat_mapping], flat_mapping);
+    }
+  }
+
+  // Update bitmap to indicate the levels that have free blocks
+  _fl_bitmap.fetch_or(fl_bitmap);
+}
+
+void JSMallocZ::insert_blocks(BlockHeader *first, BlockHeader *last, uint32_t flat_mapping) {
+  BlockHeader *head, *new_head;
 
-    if(next_blk != nullptr && current_blk->is_free() && next_blk->is_free()) {
-      current_blk = JSMallocBase::coalesce_blocks(current_blk, next_blk);
-      insert_block(current_blk);
+  do {
+    head = _blocks[flat_mapping].load();
+    BlockHeader *offset = head;
+
+    if(head == nullptr) {
+      offset = reinterpret_cast<BlockHeader *>(std::numeric_limits<uint64_t>::max());
+    }
+
+    blk_set_next(last, reinterpret_cast<BlockHeader *>(JSMallocUtil::from_offset(_block_start, false, reinterpret_cast<uint64_t>(offset))));
+
+    uint64_t version = (uint32_t)(JSMallocUtil::get_bits(reinterpret_cast<uint64_t>(head), true) + 1);
+    new_head = reinterpret_cast<BlockHeader *>(version);
+    JSMallocUtil::set_offset(false, calculate_offset(first, _block_start), reinterpret_cast<uint64_t *>(&new_head));
+  } while(!_blocks[flat_mapping].compare_exchange_strong(head, new_head));
+}
+
+size_t JSMallocZ::largest_free_block() {
+  uint64_t fl_bitmap = _fl_bitmap.load();
+  if(fl_bitmap == 0) {
+    return 0;
+  }
+
+  // The smallest block size of the largest non-empty free-list, which is
+  // the inverse of get_mapping. The last list holds all larger blocks.
+  // Allocation sizes are aligned up, so the bound is aligned down.
+  size_t flat_mapping = JSMallocUtil::ilog2(fl_bitmap);
+  size_t fl = (flat_mapping >> _sl_index_log2) + _min_alloc_size_log2;
+  size_t sl = flat_mapping & (_sl_index - 1);
+  return JSMallocUtil::align_down((1UL << fl) + (sl << (fl - _sl_index_log2)), _mbs);
+}
+
+void JSMallocZ::rebase(void *pool, size_t pool_size) {
+  initialize(pool, pool_size, true);
+}
+
+BlockHeader *JSMallocZ::sort_blocks(BlockHeader *blocks) {
+  if(blocks == nullptr || blk_get_next(blocks) == nullptr) {
+    return blocks;
+  }
+
+  // Split the chain in two halves
+  BlockHeader *slow = blocks;
+  BlockHeader *fast = blk_get_next(blocks);
+  while(fast != nullptr && blk_get_next(fast) != nullptr) {
+    slow = blk_get_next(slow);
+    fast = blk_get_next(blk_get_next(fast));
+  }
+
+  BlockHeader *first = blocks;
+  BlockHeader *second = blk_get_next(slow);
+  blk_set_next(slow, nullptr);
+
+  first = sort_blocks(first);
+  second = sort_blocks(second);
+
+  // Merge the sorted halves
+  BlockHeader *head = nullptr;
+  BlockHeader *tail = nullptr;
+  while(first != nullptr && second != nullptr) {
+    BlockHeader **lowest = (first < second) ? &first : &second;
+    BlockHeader *blk = *lowest;
+    *lowest = blk_get_next(blk);
+
+    if(tail == nullptr) {
+      head = blk;
     } else {
-      current_blk = next_blk;
+      blk_set_next(tail, blk);
+    }
+    tail = blk;
+  }
+
+  blk_set_next(tail, (first != nullptr) ? first : second);
+
+  return head;
+}
+
+void JSMallocZ::aggregate() {
+  // Blocks have no headers with deferred coalescing, so neighbouring blocks
+  // cannot be found by walking the pool. Instead, the free-lists are
+  // detached, and their blocks are sorted by address, so that adjacent free
+  // blocks end up next to each other.
+  BlockHeader *blocks = nullptr;
+
+  for(uint32_t flat_mapping = 0; flat_mapping <= _num_lists; flat_mapping++) {
+    uint64_t head_bits = reinterpret_cast<uint64_t>(_blocks[flat_mapping].load());
+
+    // Empty the free-list, bumping the version like remove_block does
+    BlockHeader *new_head = reinterpret_cast<BlockHeader *>((uint64_t)(uint32_t)(JSMallocUtil::get_bits(head_bits, true) + 1));
+    JSMallocUtil::set_offset(false, calculate_offset(nullptr, _block_start), reinterpret_cast<uint64_t *>(&new_head));
+    _blocks[flat_mapping].store(new_head);
+
+    // A head of nullptr is a free-list that has never been used
+    BlockHeader *current = (head_bits == 0) ? nullptr : reinterpret_cast<BlockHeader *>(JSMallocUtil::from_offset(_block_start, false, head_bits));
+    while(current != nullptr) {
+      BlockHeader *next = blk_get_next(current);
+      blk_set_next(current, blocks);
+      blocks = current;
+      current = next;
     }
   }
+
+  _fl_bitmap.store(0);
+
+  blocks = sort_blocks(blocks);
+
+  // Coalesce runs of adjacent blocks, and hand them back in batches. A
+  // range is only handed back once its blocks have been unlinked, since
+  // freeing it overwrites the header of its first block.
+  static const size_t batch_size = 64;
+  FreeRange ranges[batch_size];
+  size_t count = 0;
+
+  while(blocks != nullptr) {
+    uintptr_t start = reinterpret_cast<uintptr_t>(blocks);
+    uintptr_t end = start + blocks->get_size();
+    blocks = blk_get_next(blocks);
+
+    while(blocks != nullptr && reinterpret_cast<uintptr_t>(blocks) == end) {
+      end += blocks->get_size();
+      blocks = blk_get_next(blocks);
+    }
+
+    ranges[count++] = {reinterpret_cast<void *>(start), end - start};
+    if(count == batch_size) {
+      free_ranges(ranges, count);
+      count = 0;
+    }
+  }
+
+  if(count > 0) {
+    free_ranges(ranges, count);
+  }
 }
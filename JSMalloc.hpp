@@ -36,14 +36,21 @@ public:
 
 struct Mapping;
 
+// A range of memory handed back to an allocator in bulk.
+struct FreeRange {
+  void *start;
+  size_t size;
+};
+
 constexpr size_t BLOCK_HEADER_LENGTH_SMALL = 0;
 constexpr size_t BLOCK_HEADER_LENGTH = sizeof(BlockHeader);
 
 template <typename Config>
 class JSMallocBase {
 private:
-  size_t _internal_fragmentation = 0;
-  size_t _allocated = 0;
+  // Updated concurrently by allocating threads, only used for statistics.
+  std::atomic<size_t> _internal_fragmentation{0};
+  std::atomic<size_t> _allocated{0};
 
 public:
   JSMallocBase(void *pool, size_t pool_size, bool start_full);
@@ -51,8 +58,17 @@ public:
   void reset(bool initial_block_allocated = true);
   void *allocate(size_t size);
 
+  // Allocates count blocks and returns how many were allocated. Blocks are
+  // allocated in order, so the first returned number of entries in out are
+  // valid. Without block headers, a batch is carved from a single block.
+  size_t allocate_many(const size_t *sizes, void **out, size_t count);
+
   double internal_fragmentation();
 
+  // Calls do_block for every block in the free-lists. Must not be called
+  // concurrently with allocations or frees.
+  void free_blocks_do(void (*do_block)(void *ctx, void *start, size_t size), void *ctx);
+
   // TODO: Should be removed. Used for debugging.
   void print_phys_blks();
   void print_blk(BlockHeader *blk);
@@ -165,8 +181,31 @@ public:
   // contains one allocated block and no more.
   void free_range(void *start_ptr, size_t size);
 
-  // Manually trigger block coalescing.
+  // Frees count ranges, with the same assumption as free_range for each of
+  // them. The blocks are chained per free-list first, so that each
+  // free-list is only updated once.
+  void free_ranges(const FreeRange *ranges, size_t count);
+
+  // Coalesces adjacent free blocks. All free-lists are detached while the
+  // blocks are coalesced, so this must not be called concurrently with
+  // allocations or frees.
   void aggregate();
+
+  // Returns a lower bound of the largest free block, read from the
+  // first-level bitmap, or 0 if there are no free blocks. An allocation
+  // of at most this size is guaranteed to find a block.
+  size_t largest_free_block();
+
+  // Moves the allocator to a new pool and marks all of it as allocated, so
+  // that an allocator instance can be reused for another pool.
+  void rebase(void *pool, size_t pool_size);
+
+private:
+  // Inserts the chain first -> ... -> last at the head of a free-list.
+  void insert_blocks(BlockHeader *first, BlockHeader *last, uint32_t flat_mapping);
+
+  // Sorts a chain of blocks by address, using merge sort.
+  BlockHeader *sort_blocks(BlockHeader *blocks);
 };
 
 #endif // JSMALLOC_HPP
@@ -1,11 +1,13 @@
 #ifndef AAZ_ALLOCATORS
 #define AAZ_ALLOCATORS
 
+#include "gc/z/GapBump.hpp"
 #include "gc/z/JSMalloc.hpp"
 // #include "gc/z/ibuddy.hpp"
 #include "gc/z/btbuddy.hpp"
 // #include "gc/z/bbuddy.hpp"
 #include "gc/z/buddy_config.hpp"
+#include "memory/allocation.hpp"
 
 // class ZBuddyAllocator : public IBuddyAllocator<ZConfig> {
 // public:
@@ -20,19 +22,49 @@
 //   void aggregate() {empty_lazy_list();}
 // };
 
-class ZinaryBuddyAllocator : public BTBuddyAllocator<ZConfig> {
+template <typename Config>
+class ZBinaryBuddyAllocator : public BTBuddyAllocator<Config> {
+protected:
+  // Region trees are allocated on the C-heap as mtGC, so that they show up
+  // in NMT together with the rest of the recycling metadata.
+  unsigned char* allocate_tree(size_t size) override {return NEW_C_HEAP_ARRAY(unsigned char, size, mtGC);}
+  void free_tree(unsigned char* tree, size_t size) override {FREE_C_HEAP_ARRAY(unsigned char, tree);}
+
 public:
-  ZinaryBuddyAllocator(void* start, size_t size, int lazyThreshold, bool startFull) 
-    : BTBuddyAllocator(start, lazyThreshold, startFull) {} 
+  ZBinaryBuddyAllocator(void* start, size_t size, int lazyThreshold, bool startFull) 
+    : BTBuddyAllocator<Config>(start, lazyThreshold, startFull) {} 
+  ~ZBinaryBuddyAllocator() {this->release_trees();}
 
-  void reset() {fill();}
+  void reset() {this->fill();}
   // void* allocate(size_t size) {return allocate(size);} already exists in super class
-  void free(void* ptr) {deallocate(ptr);}
-  void free(void* ptr, size_t size) {deallocate(ptr, size);}
-  void free_range(void* ptr, size_t size) {deallocate_range(ptr,size);} 
-  void aggregate() {empty_lazy_list();}
+  size_t allocate_many(const size_t* sizes, void** out, size_t count) {
+    size_t allocated = 0;
+    while (allocated < count && (out[allocated] = this->allocate(sizes[allocated])) != nullptr) {
+      allocated++;
+    }
+    return allocated;
+  }
+  void free(void* ptr) {this->deallocate(ptr);}
+  void free(void* ptr, size_t size) {this->deallocate(ptr, size);}
+  void free_range(void* ptr, size_t size) {this->deallocate_range(ptr,size);} 
+  void free_ranges(const FreeRange* ranges, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      this->deallocate_range(ranges[i].start, ranges[i].size);
+    }
+  }
+  void aggregate() {this->empty_lazy_list();}
+  void rebase(void* start, size_t size) {BuddyAllocator<Config>::rebase(start);}
+  // Freed ranges are trimmed to blocks of at least the smallest block size
+  size_t free_granularity() {return Config::minBlockSize;}
+  // size_t metadata_size() already exists in super class
+  // void free_blocks_do(...) already exists in super class
 };
 
+// Recycled small pages
+using ZinaryBuddyAllocator = ZBinaryBuddyAllocator<ZCompactConfig>;
+// Recycled medium pages
+using ZMediumBuddyAllocator = ZBinaryBuddyAllocator<ZMediumConfig>;
+
 class ZTLSFAllocator : public JSMallocZ {
 public:
   ZTLSFAllocator(void* start, size_t size, int lazyThreshold, bool startFull) 
@@ -40,10 +72,56 @@ public:
 
   // void reset() {reset();}
   // void* allocate(size_t size) {return allocate(size);} already exists in super class
+  // size_t allocate_many(const size_t* sizes, void** out, size_t count) already exists in super class
   // void free(void* ptr) {free(ptr);}
   // void free(void* ptr, size_t size) {free(ptr, size);}
   // void free_range(void* ptr, size_t size) {free_range(ptr,size);} 
+  // void free_ranges(const FreeRange* ranges, size_t count) {free_ranges(ranges, count);}
   // void aggregate() {aggregate();}
+  // void rebase(void* start, size_t size) {rebase(start, size);}
+  size_t free_granularity() {return 1;}
+  size_t metadata_size() {return sizeof(*this);}
+  // void free_blocks_do(...) already exists in super class
+};
+
+class ZGapBumpAllocator : public GapBumpAllocator {
+protected:
+  // The gap vector is allocated on the C-heap as mtGC, like the region
+  // trees of the buddy allocators.
+  uint32_t* allocate_gaps(size_t count) override {return NEW_C_HEAP_ARRAY(uint32_t, count, mtGC);}
+  void free_gaps(uint32_t* gaps, size_t count) override {FREE_C_HEAP_ARRAY(uint32_t, gaps);}
+
+public:
+  ZGapBumpAllocator(void* start, size_t size, int lazyThreshold, bool startFull)
+    : GapBumpAllocator(start, size) {
+    if (!startFull) {
+      this->deallocate_range(start, size);
+    }
+  }
+  ~ZGapBumpAllocator() {this->release_gaps();}
+
+  void reset() {this->fill();}
+  // void* allocate(size_t size) {return allocate(size);} already exists in super class
+  size_t allocate_many(const size_t* sizes, void** out, size_t count) {
+    size_t allocated = 0;
+    while (allocated < count && (out[allocated] = this->allocate(sizes[allocated])) != nullptr) {
+      allocated++;
+    }
+    return allocated;
+  }
+  void free(void* ptr) {ShouldNotReachHere();} // The gaps need the size of the block
+  void free(void* ptr, size_t size) {this->deallocate_range(ptr, size);}
+  void free_range(void* ptr, size_t size) {this->deallocate_range(ptr, size);}
+  void free_ranges(const FreeRange* ranges, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      this->deallocate_range(ranges[i].start, ranges[i].size);
+    }
+  }
+  void aggregate() {this->coalesce();}
+  size_t free_granularity() {return 1;}
+  // void rebase(void* start, size_t size) already exists in super class
+  // size_t metadata_size() already exists in super class
+  // void free_blocks_do(...) already exists in super class
 };
 
 #endif
\ No newline at end of file
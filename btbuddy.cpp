@@ -5,6 +5,7 @@
 #include "buddy_instantiations.hpp"
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sys/mman.h>
 #include <thread>
@@ -25,24 +26,39 @@ void BTBuddyAllocator<Config>::init_bitmaps(bool startFull) {
 
   BuddyAllocator<Config>::set_bitmaps(freeBlocksPattern, sizeMapPattern);
 
+  // Untouched regions take on the new state without being materialized.
+  // Trees that are already materialized are kept and reinitialized, so that
+  // a reused allocator does not have to allocate them again.
+  _untouchedFree = !startFull;
   for (int r = 0; r < Config::numRegions; r++) {
-    if (startFull) {
-      for (unsigned int i = 0;
-           i < (1U << BuddyAllocator<Config>::_numLevels) - 1; i++) {
-        set_tree(r, i, 0);
-      }
-    } else {
-      for (int l = 0; l < BuddyAllocator<Config>::_numLevels; l++) {
-        const int tree_height = BuddyAllocator<Config>::_numLevels - l;
-        for (unsigned int i = BuddyAllocator<Config>::index_of_level(l);
-             i < BuddyAllocator<Config>::index_of_level(l + 1); i++) {
-          set_tree(r, i, tree_height);
-        }
-      }
+    if (_btTree[r] != nullptr) {
+      init_tree(_btTree[r]);
     }
   }
 }
 
+template <typename Config>
+void BTBuddyAllocator<Config>::init_tree(unsigned char *tree) {
+  if (!_untouchedFree) {
+    memset(tree, 0, _treeSize);
+    return;
+  }
+
+  for (int l = 0; l < BuddyAllocator<Config>::_numLevels; l++) {
+    const unsigned char tree_height = BuddyAllocator<Config>::_numLevels - l;
+    const unsigned char num_bits = _btBits[l];
+    const unsigned int level_nodes = 1U << l;
+
+    // Replicate the height over a byte, then fill the level bytewise
+    unsigned char pattern = 0;
+    for (unsigned int bit = 0; bit < 8; bit += num_bits) {
+      pattern |= tree_height << bit;
+    }
+    memset(tree + _levelOffsets[l], pattern,
+           (level_nodes * num_bits + 7) / 8);
+  }
+}
+
 template <typename Config>
 BTBuddyAllocator<Config>::BTBuddyAllocator(void *start, int lazyThreshold,
                                            bool startFull)
@@ -57,33 +73,26 @@ BTBuddyAllocator<Config>::BTBuddyAllocator(void *start, int lazyThreshold,
     }
   }
 
+  // The height stored in a node is at most the number of levels below it,
+  // so the three lowest levels fit in one or two bits, and the remaining
+  // levels in a nibble as long as the tree is less than 16 levels high.
   _btBits[Config::numLevels - 1] = 1;
   _btBits[Config::numLevels - 2] = 2;
   _btBits[Config::numLevels - 3] = 2;
   for (int i = Config::numLevels - 4; i >= 0; i--) {
-    _btBits[i] = 8;
+    _btBits[i] = Config::numLevels < 16 ? 4 : 8;
   }
-  // for (int i = Config::numLevels - 4; i >= Config::numLevels - 16 && i >= 0;
-  //      i--) {
-  //   _btBits[i] = 4;
-  // }
-  // for (int i = Config::numLevels - 16; i >= 0; i--) {
-  //   _btBits[i] = 8;
-  // }
 
   unsigned int start_offset = 0;
-  for (int i = 0; i < Config::numLevels - 1; i++) {
+  for (int i = 0; i < Config::numLevels; i++) {
     unsigned int level_blocks = 1U << i;
     unsigned int level_size = level_blocks * _btBits[i];
-    // std::cout << "Level " << i << " bits: " << (int)_btBits[i]
-    // << " size: " << level_size << std::endl;
     // round up to nearest multiple of 8
     level_size = (level_size + 7) & ~7;
-    // std::cout << "Level " << i << " blocks: " << level_blocks
-    // << " size: " << level_size << std::endl;
+    _levelOffsets[i] = start_offset;
     start_offset += level_size / 8;
-    _levelOffsets[i + 1] = start_offset;
   }
+  _treeSize = start_offset;
 
   // print start_offset
   // for (int i = 0; i < Config::numLevels; i++) {
@@ -95,6 +104,94 @@ BTBuddyAllocator<Config>::BTBuddyAllocator(void *start, int lazyThreshold,
   init_bitmaps(startFull);
 }
 
+template <typename Config> BTBuddyAllocator<Config>::~BTBuddyAllocator() {
+  release_trees();
+}
+
+template <typename Config>
+unsigned char *BTBuddyAllocator<Config>::allocate_tree(size_t size) {
+  return static_cast<unsigned char *>(std::malloc(size));
+}
+
+template <typename Config>
+void BTBuddyAllocator<Config>::free_tree(unsigned char *tree, size_t size) {
+  std::free(tree);
+}
+
+template <typename Config> void BTBuddyAllocator<Config>::release_trees() {
+  for (int r = 0; r < Config::numRegions; r++) {
+    if (_btTree[r] != nullptr) {
+      free_tree(_btTree[r], _treeSize);
+      _btTree[r] = nullptr;
+    }
+  }
+  _materializedTrees = 0;
+}
+
+template <typename Config>
+unsigned char *BTBuddyAllocator<Config>::materialize_tree(uint8_t region) {
+  unsigned char *tree = allocate_tree(_treeSize);
+  init_tree(tree);
+  _btTree[region] = tree;
+  _materializedTrees++;
+  return tree;
+}
+
+template <typename Config> size_t BTBuddyAllocator<Config>::metadata_size() {
+  return sizeof(*this) + _materializedTrees * _treeSize;
+}
+
+template <typename Config> size_t BTBuddyAllocator<Config>::largest_free_block() {
+  unsigned char height = 0;
+  for (uint8_t r = 0; r < BuddyAllocator<Config>::_numRegions; r++) {
+    // The root of each tree holds the height of the largest free block
+    BuddyAllocator<Config>::_regionMutexes[r].lock();
+    const unsigned char root = get_tree(r, 0);
+    BuddyAllocator<Config>::_regionMutexes[r].unlock();
+    height = root > height ? root : height;
+  }
+
+  if (height == 0) {
+    return 0;
+  }
+
+  return BuddyAllocator<Config>::size_of_level(
+      BuddyAllocator<Config>::_numLevels - height);
+}
+
+template <typename Config>
+void BTBuddyAllocator<Config>::free_blocks_do(
+    void (*do_block)(void *ctx, void *start, size_t size), void *ctx) {
+  for (uint8_t r = 0; r < BuddyAllocator<Config>::_numRegions; r++) {
+    tree_blocks_do(r, 0, do_block, ctx);
+  }
+  BuddyAllocator<Config>::lazy_blocks_do(do_block, ctx);
+}
+
+template <typename Config>
+void BTBuddyAllocator<Config>::tree_blocks_do(
+    uint8_t region, unsigned int index,
+    void (*do_block)(void *ctx, void *start, size_t size), void *ctx) {
+  const unsigned char height = get_tree(region, index);
+  if (height == 0) {
+    // Nothing free below this node
+    return;
+  }
+
+  const uint8_t level = BuddyAllocator<Config>::level_of_index(index);
+  if (height == BuddyAllocator<Config>::_numLevels - level) {
+    // The entire block is free
+    do_block(ctx,
+             reinterpret_cast<void *>(
+                 BuddyAllocator<Config>::get_address(region, index)),
+             BuddyAllocator<Config>::size_of_level(level));
+    return;
+  }
+
+  tree_blocks_do(region, 2 * index + 1, do_block, ctx);
+  tree_blocks_do(region, 2 * index + 2, do_block, ctx);
+}
+
 // Creates a buddy allocator at the given address
 template <typename Config>
 BTBuddyAllocator<Config> *
@@ -121,71 +218,67 @@ static unsigned char bitmask_table[4][8] = {
     {0b0, 0b0, 0b0, 0b0, 0b0, 0b0, 0b0, 0b0},
     {0b11110000, 0b0, 0b0, 0b0, 0b00001111, 0b0, 0b0, 0b0}};
 
+template <typename Config>
+inline unsigned char BTBuddyAllocator<Config>::untouched_value(unsigned int index) {
+  if (!_untouchedFree) {
+    return 0;
+  }
+  return BuddyAllocator<Config>::_numLevels -
+         BuddyAllocator<Config>::level_of_index(index);
+}
+
 template <typename Config>
 inline void BTBuddyAllocator<Config>::set_tree(uint8_t region,
                                                unsigned int index,
                                                unsigned char value) {
+  unsigned char *tree = _btTree[region];
+  if (tree == nullptr) {
+    if (value == untouched_value(index)) {
+      return;
+    }
+    tree = materialize_tree(region);
+  }
 
-  // _btTree[region][index] = value;
-  // return;
   const uint8_t level = BuddyAllocator<Config>::level_of_index(index);
-  if (level < BuddyAllocator<Config>::_numLevels - 3) {
-    _btTree[region][index] = value;
-    return;
-  }
   const unsigned int level_start = BuddyAllocator<Config>::index_of_level(level);
-  // std::cout << "index: " << index << " level: " << static_cast<int>(level)
-  // << " value: " << (int)value << std::endl;
   const unsigned int offset = _levelOffsets[level];
   const unsigned char num_bits = _btBits[level];
 
-  const unsigned int byte_offset =
-      offset + (index - level_start) * num_bits / 8;
-  const unsigned int bit_offset = (index - level_start) * num_bits % 8;
+  const unsigned int bit_index = (index - level_start) * num_bits;
+  unsigned char *byte = &tree[offset + (bit_index >> 3U)];
 
-  // std::cout << "byte_offset: " << byte_offset
-  // << " bit_offset: " << static_cast<int>(bit_offset) << std::endl;
+  if (num_bits == 8) {
+    *byte = value;
+    return;
+  }
 
   // Replace num_bits bits starting from bit_offset with value
-  unsigned char *byte = &_btTree[region][byte_offset];
+  const unsigned int bit_offset = bit_index & 0x7U;
   *byte =
       (*byte & bitmask_table[num_bits - 1][bit_offset]) | (value << bit_offset);
-
-  // print binary representation of byte
-  // for (int i = 7; i >= 0; i--) {
-  //   std::cout << ((*byte >> i) & 1);
-  // }
-  // std::cout << std::endl;
 }
 
 template <typename Config>
 inline unsigned char BTBuddyAllocator<Config>::get_tree(uint8_t region,
                                                         unsigned int index) {
-
-  // return _btTree[region][index];
-  const uint8_t level = BuddyAllocator<Config>::level_of_index(index);
-  if (level < BuddyAllocator<Config>::_numLevels - 3) {
-    return _btTree[region][index];
+  const unsigned char *tree = _btTree[region];
+  if (tree == nullptr) {
+    return untouched_value(index);
   }
 
+  const uint8_t level = BuddyAllocator<Config>::level_of_index(index);
   const unsigned int level_start = BuddyAllocator<Config>::index_of_level(level);
-
   const unsigned int offset = _levelOffsets[level];
   const unsigned char num_bits = _btBits[level];
 
-  // const unsigned int index_offset = index - level_start;
-  const unsigned int byte_offset =
-      offset + (((index - level_start) * num_bits) >> 3U);
-  // const unsigned int bit_offset = index_offset * num_bits % 8;
-  const unsigned int bit_offset = ((index - level_start) * num_bits) & 0x7U;
+  const unsigned int bit_index = (index - level_start) * num_bits;
+  const unsigned char byte = tree[offset + (bit_index >> 3U)];
 
-  const unsigned char byte = _btTree[region][byte_offset];
-  // const unsigned char value = (byte >> bit_offset) & (0xFF >> (8 -
-  // num_bits));
-  // const unsigned char value = (byte >> bit_offset) & ((1U << num_bits) - 1U);
-  return (byte >> bit_offset) & (0xFF >> (8 - num_bits));
+  if (num_bits == 8) {
+    return byte;
+  }
 
-  // return value;
+  return (byte >> (bit_index & 0x7U)) & (0xFF >> (8 - num_bits));
 }
 
 // Function to read the CPU cycle counter
@@ -346,7 +439,10 @@ void BTBuddyAllocator<Config>::deallocate_internal(void *ptr, size_t size) {
     if (left_value == right_value && left_value == l) {
       // _btTree[region][block_index] = l + 1;
       set_tree(region, block_index, l + 1);
-      BuddyAllocator<Config>::set_split_block(region, block_index, false);
+      if (BuddyAllocator<Config>::_sizeMapIsBitmap &&
+          BuddyAllocator<Config>::_sizeMapEnabled) {
+        BuddyAllocator<Config>::set_split_block(region, block_index, false);
+      }
     } else {
       set_tree(region, block_index,
                left_value > right_value ? left_value : right_value);
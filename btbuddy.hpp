@@ -11,7 +11,7 @@ template <typename Config>
 class BTBuddyAllocator : public BuddyAllocator<Config> {
 public:
   BTBuddyAllocator(void *start, int lazyThreshold, bool startFull);
-  ~BTBuddyAllocator() = default;
+  virtual ~BTBuddyAllocator();
   BTBuddyAllocator(const BTBuddyAllocator &) = delete;
   BTBuddyAllocator &operator=(const BTBuddyAllocator &) = delete;
 
@@ -22,20 +22,55 @@ public:
 
   void print_free_list() override;
 
+  // Number of bytes of allocator metadata, including the region trees that
+  // have been materialized so far.
+  size_t metadata_size();
+
+  // Size of the largest free block in any region, or 0 if there are no free
+  // blocks. Blocks in the lazy lists are not included, since they only serve
+  // allocations of their own size.
+  size_t largest_free_block();
+
+  // Calls do_block for every free block, including the blocks in the lazy
+  // lists. Must not be called concurrently with allocations or frees.
+  void free_blocks_do(void (*do_block)(void *ctx, void *start, size_t size),
+                      void *ctx);
+
 protected:
   void *allocate_internal(size_t size) override;
   void deallocate_internal(void *ptr, size_t size) override;
   void init_bitmaps(bool startFull) override;
 
+  // Storage for the per-region trees. Only called after construction, so
+  // subclasses may override these, but must then call release_trees() from
+  // their own destructor.
+  virtual unsigned char *allocate_tree(size_t size);
+  virtual void free_tree(unsigned char *tree, size_t size);
+  void release_trees();
+
 private:
   void init_free_lists();
   uint8_t tree_height(size_t size);
   void set_tree(uint8_t region, unsigned int index, unsigned char value);
   unsigned char get_tree(uint8_t region, unsigned int index);
-  
-  unsigned char _btTree[Config::numRegions][1U << Config::numLevels];
+  unsigned char untouched_value(unsigned int index);
+  unsigned char *materialize_tree(uint8_t region);
+  void init_tree(unsigned char *tree);
+  void tree_blocks_do(uint8_t region, unsigned int index,
+                      void (*do_block)(void *ctx, void *start, size_t size),
+                      void *ctx);
+
+  // The tree of each region is packed level by level, using only as many
+  // bits per node as the largest height on that level needs. Trees are
+  // materialized the first time a region is written with a value that
+  // differs from the untouched state, which is either entirely allocated
+  // or entirely free depending on the last init_bitmaps().
+  unsigned char *_btTree[Config::numRegions] = {nullptr};
   unsigned char _btBits[Config::numLevels] = {8};
   unsigned int _levelOffsets[Config::numLevels] = {0};
+  size_t _treeSize = 0;
+  int _materializedTrees = 0;
+  bool _untouchedFree = false;
 };
 
 #endif // BTBUDDY_HPP
\ No newline at end of file
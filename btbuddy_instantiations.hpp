@@ -5,6 +5,8 @@
 #include "buddy_config.hpp"
 
 template class BTBuddyAllocator<ZConfig>;
+template class BTBuddyAllocator<ZCompactConfig>;
+template class BTBuddyAllocator<ZMediumConfig>;
 template class BTBuddyAllocator<SmallSingleConfig>;
 template class BTBuddyAllocator<SmallDoubleConfig>;
 template class BTBuddyAllocator<LargeQuadConfig>;
@@ -533,6 +533,17 @@ template <typename Config> void BuddyAllocator<Config>::empty_lazy_list() {
   }
 }
 
+template <typename Config>
+void BuddyAllocator<Config>::lazy_blocks_do(
+    void (*do_block)(void *ctx, void *start, size_t size), void *ctx) {
+  for (uint8_t l = 0; l < _numLevels; l++) {
+    for (double_link *block = _lazyList[l].next; block != &_lazyList[l];
+         block = block->next) {
+      do_block(ctx, block, size_of_level(l));
+    }
+  }
+}
+
 template <typename Config>
 void BuddyAllocator<Config>::push_free_list(uintptr_t ptr, uint8_t region,
                                             uint8_t level) {
@@ -600,6 +611,17 @@ template <typename Config> void BuddyAllocator<Config>::fill() {
   for (auto &size : BuddyAllocator<Config>::_freeSizes) {
     size = 0;
   }
+
+  // Blocks on the lazy lists belong to the memory that was just filled
+  for (int l = 0; l < Config::numLevels; l++) {
+    _lazyList[l] = {&_lazyList[l], &_lazyList[l]};
+    _lazyListSize[l] = 0;
+  }
+}
+
+template <typename Config> void BuddyAllocator<Config>::rebase(void *start) {
+  _start = reinterpret_cast<uintptr_t>(start);
+  fill();
 }
 
 // Prints the free list
@@ -29,10 +29,17 @@ public:
   virtual void deallocate_range(void *ptr, size_t size);
   void empty_lazy_list();
   void fill();
+  // Moves the allocator to a new memory area of the same geometry and
+  // fills it, so that an allocator instance can be reused.
+  void rebase(void *start);
 
   virtual void print_free_list();
   void print_bitmaps();
 
+  // Calls do_block for every block in the lazy lists
+  void lazy_blocks_do(void (*do_block)(void *ctx, void *start, size_t size),
+                      void *ctx);
+
 protected:
   void init_free_lists();
   void set_bitmaps(unsigned char freeBlocksPattern,
@@ -4,7 +4,8 @@
 #include <cstddef>
 
 template <unsigned int MIN_BLOCK_SIZE_LOG2, unsigned int MAX_BLOCK_SIZE_LOG2,
-          int NUM_REGIONS, bool USE_SIZEMAP, size_t SIZE_BITS>
+          int NUM_REGIONS, bool USE_SIZEMAP, size_t SIZE_BITS,
+          bool USE_ALLOC_BITMAP = true>
 struct BuddyConfig {
   static const size_t minBlockSizeLog2 = MIN_BLOCK_SIZE_LOG2;
   static const size_t maxBlockSizeLog2 = MAX_BLOCK_SIZE_LOG2;
@@ -14,7 +15,9 @@ struct BuddyConfig {
       MAX_BLOCK_SIZE_LOG2 - MIN_BLOCK_SIZE_LOG2 + 1;
   static const int numRegions = NUM_REGIONS;
   static const bool useSizeMap = USE_SIZEMAP;
-  static const int allocedBitmapSize = (1U << (numLevels)) / 8;
+  static const bool useAllocBitmap = USE_ALLOC_BITMAP;
+  static const int allocedBitmapSize =
+      USE_ALLOC_BITMAP ? (1U << (numLevels)) / 8 : 0;
   static const size_t sizeBits = SIZE_BITS;
   static const int sizeBitmapSize =
       !USE_SIZEMAP       ? 0
@@ -24,6 +27,14 @@ struct BuddyConfig {
 
 // using ZConfig = BuddyConfig<4, 18, 8, false, 4>;
 using ZConfig = BuddyConfig<4, 18, 8, true, 4>;
+// Same geometry as ZConfig, but without the size map and the allocated-block
+// bitmap. Used by the binary tree buddy allocator for recycled ZGC pages,
+// where every free is given an explicit size.
+using ZCompactConfig = BuddyConfig<4, 18, 8, false, 0, false>;
+// Compact configuration for recycled ZGC medium pages. Covers the largest
+// (32M) medium page with 4M blocks, which is also the largest medium object.
+// Smaller medium pages only use the first regions.
+using ZMediumConfig = BuddyConfig<12, 22, 8, false, 0, false>;
 using SmallSingleConfig = BuddyConfig<4, 8, 1, true, 0>;
 using SmallDoubleConfig = BuddyConfig<4, 8, 2, true, 4>;
 using LargeQuadConfig = BuddyConfig<4, 21, 4, true, 0>;
@@ -5,6 +5,8 @@
 #include "buddy_allocator.hpp"
 
 template class BuddyAllocator<ZConfig>;
+template class BuddyAllocator<ZCompactConfig>;
+template class BuddyAllocator<ZMediumConfig>;
 template class BuddyAllocator<SmallSingleConfig>;
 template class BuddyAllocator<SmallDoubleConfig>;
 template class BuddyAllocator<LargeQuadConfig>;
@@ -48,6 +48,10 @@ size_t ZAllocatorEden::remaining() const {
   return _object_allocator.remaining();
 }
 
+void ZAllocatorEden::register_recycled_hole(zaddress addr, size_t size) {
+  _object_allocator.register_recycled_hole(addr, size);
+}
+
 ZPageAge ZAllocatorForRelocation::install() {
   for (uint i = 0; i < ZAllocator::_relocation_allocators; ++i) {
     if (_relocation[i] == nullptr) {
@@ -62,9 +62,12 @@ public:
   ZAllocatorEden();
 
   // Mutator allocation
-  zaddress alloc_tlab(size_t size);
+  zaddress alloc_tlab(size_t min_size, size_t requested_size, size_t* actual_size);
   zaddress alloc_object(size_t size);
 
+  // Recycled young pages
+  void register_recycled_hole(zaddress addr, size_t size);
+
   // Statistics
   size_t tlab_used() const;
   size_t remaining() const;
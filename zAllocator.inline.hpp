@@ -41,9 +41,9 @@ inline ZAllocatorForRelocation* ZAllocator::old() {
   return relocation(ZPageAge::old);
 }
 
-inline zaddress ZAllocatorEden::alloc_tlab(size_t size) {
-  guarantee(size <= ZHeap::heap()->max_tlab_size(), "TLAB too large");
-  return _object_allocator.alloc_object(size);
+inline zaddress ZAllocatorEden::alloc_tlab(size_t min_size, size_t requested_size, size_t* actual_size) {
+  guarantee(requested_size <= ZHeap::heap()->max_tlab_size(), "TLAB too large");
+  return _object_allocator.alloc_tlab(min_size, requested_size, actual_size);
 }
 
 inline zaddress ZAllocatorEden::alloc_object(size_t size) {
@@ -142,11 +142,13 @@ bool ZCollectedHeap::requires_barriers(stackChunkOop obj) const {
 }
 
 HeapWord* ZCollectedHeap::allocate_new_tlab(size_t min_size, size_t requested_size, size_t* actual_size) {
+  const size_t min_size_in_bytes = ZUtils::words_to_bytes(align_object_size(min_size));
   const size_t size_in_bytes = ZUtils::words_to_bytes(align_object_size(requested_size));
-  const zaddress addr = ZAllocator::eden()->alloc_tlab(size_in_bytes);
+  size_t actual_size_in_bytes = 0;
+  const zaddress addr = ZAllocator::eden()->alloc_tlab(min_size_in_bytes, size_in_bytes, &actual_size_in_bytes);
 
   if (!is_null(addr)) {
-    *actual_size = requested_size;
+    *actual_size = ZUtils::bytes_to_words(actual_size_in_bytes);
   }
 
   return (HeapWord*)untype(addr);
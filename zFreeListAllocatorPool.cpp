@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "gc/z/AllocatorWrapper.hpp"
+#include "gc/z/zArray.inline.hpp"
+#include "gc/z/zFreeListAllocatorPool.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "logging/log.hpp"
+#include "utilities/debug.hpp"
+
+ZFreeListAllocatorPool::ZFreeListAllocatorPool()
+  : _lock(),
+    _available(),
+    _used(),
+    _max_used() {}
+
+ZFreeListAllocatorPool::~ZFreeListAllocatorPool() {
+  for (uint kind = 0; kind < ZFreeListAllocatorKindCount; kind++) {
+    assert(_used[kind] == 0, "Allocators still checked out");
+    for (ZAllocatorWrapper* const allocator : _available[kind]) {
+      delete allocator;
+    }
+  }
+}
+
+ZAllocatorWrapper* ZFreeListAllocatorPool::checkout(ZFreeListAllocatorKind kind, void* start, size_t size) {
+  const uint index = static_cast<uint>(kind);
+  ZAllocatorWrapper* allocator = nullptr;
+
+  {
+    ZLocker<ZLock> locker(&_lock);
+    if (!_available[index].is_empty()) {
+      allocator = _available[index].pop();
+    }
+    _max_used[index] = MAX2(_max_used[index], ++_used[index]);
+  }
+
+  if (allocator == nullptr) {
+    // Pool is empty, create a new allocator. The new allocator
+    // starts with the entire memory area allocated.
+    return new ZAllocatorWrapper(start, size, 0, true, kind);
+  }
+
+  // Move a pooled allocator to the new memory area
+  allocator->rebase(start, size);
+  return allocator;
+}
+
+void ZFreeListAllocatorPool::checkin(ZAllocatorWrapper* allocator) {
+  const uint index = static_cast<uint>(allocator->allocator_kind());
+
+  ZLocker<ZLock> locker(&_lock);
+  assert(_used[index] > 0, "Allocator not checked out");
+  _available[index].push(allocator);
+  _used[index]--;
+}
+
+void ZFreeListAllocatorPool::trim() {
+  ZLocker<ZLock> locker(&_lock);
+
+  size_t pooled = 0;
+  size_t deleted = 0;
+
+  for (uint kind = 0; kind < ZFreeListAllocatorKindCount; kind++) {
+    assert(_used[kind] == 0, "Allocators still checked out");
+
+    // Only keep as many allocators as were needed by the last cycle
+    while ((size_t)_available[kind].length() > _max_used[kind]) {
+      delete _available[kind].pop();
+      deleted++;
+    }
+
+    _max_used[kind] = 0;
+    pooled += (size_t)_available[kind].length();
+  }
+
+  log_debug(gc, reloc)("Free List Allocators: " SIZE_FORMAT " pooled, " SIZE_FORMAT " deleted", pooled, deleted);
+}
+
+size_t ZFreeListAllocatorPool::used(ZFreeListAllocatorKind kind) const {
+  return _used[static_cast<uint>(kind)];
+}
+
+size_t ZFreeListAllocatorPool::available(ZFreeListAllocatorKind kind) const {
+  return (size_t)_available[static_cast<uint>(kind)].length();
+}
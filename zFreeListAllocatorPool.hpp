@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_GC_Z_ZFREELISTALLOCATORPOOL_HPP
+#define SHARE_GC_Z_ZFREELISTALLOCATORPOOL_HPP
+
+#include "gc/z/AllocatorWrapper.hpp"
+#include "gc/z/zArray.hpp"
+#include "gc/z/zLock.hpp"
+
+// Free list allocators used by recycled pages. Pages check out an allocator
+// when their free list is constructed and return it when the relocation set
+// is reset. Returned allocators are reused by later cycles, but the pool is
+// trimmed to the number of allocators used by the last cycle. Allocators
+// are pooled separately for each kind.
+class ZFreeListAllocatorPool {
+private:
+  ZLock                      _lock;
+  ZArray<ZAllocatorWrapper*> _available[ZFreeListAllocatorKindCount];
+  size_t                     _used[ZFreeListAllocatorKindCount];
+  size_t                     _max_used[ZFreeListAllocatorKindCount];
+
+public:
+  ZFreeListAllocatorPool();
+  ~ZFreeListAllocatorPool();
+
+  ZAllocatorWrapper* checkout(ZFreeListAllocatorKind kind, void* start, size_t size);
+  void checkin(ZAllocatorWrapper* allocator);
+  void trim();
+
+  size_t used(ZFreeListAllocatorKind kind) const;
+  size_t available(ZFreeListAllocatorKind kind) const;
+};
+
+#endif // SHARE_GC_Z_ZFREELISTALLOCATORPOOL_HPP
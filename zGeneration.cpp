@@ -119,7 +119,6 @@ ZGeneration::ZGeneration(ZGenerationId id, ZPageTable* page_table, ZPageAllocato
     _mark(this, page_table),
     _relocate(this),
     _relocation_set(this),
-    _r_page_index(/*{0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}*/),
     _freed(0),
     _promoted(0),
     _compacted(0),
@@ -179,6 +178,15 @@ void ZGeneration::flip_age_pages(const ZRelocationSetSelector* selector) {
   }
 }
 
+void ZGeneration::recycle_old_pages(const ZRelocationSetSelector* selector) {
+  if (is_old() && ZRecycleOldPages) {
+    _relocate.recycle_old_pages(selector->not_selected_small());
+    if (ZRecycleMediumPages) {
+      _relocate.recycle_old_pages(selector->not_selected_medium());
+    }
+  }
+}
+
 static double fragmentation_limit(ZGenerationId generation) {
   if (generation == ZGenerationId::old) {
     return ZFragmentationLimit;
@@ -188,8 +196,11 @@ static double fragmentation_limit(ZGenerationId generation) {
 }
 
 void ZGeneration::select_relocation_set(ZGenerationId generation, bool promote_all) {
+  // Pages are only kept as recycling targets when they are not all promoted
+  const ZRecyclingPolicy* const recycling_policy = (ZRecyclingAwareSelection && !promote_all) ? this->recycling_policy() : nullptr;
+
   // Register relocatable pages with selector
-  ZRelocationSetSelector selector(fragmentation_limit(generation));
+  ZRelocationSetSelector selector(fragmentation_limit(generation), recycling_policy);
   {
     ZGenerationPagesIterator pt_iter(_page_table, _id, _page_allocator);
     for (ZPage* page; pt_iter.next(&page);) {
@@ -253,6 +264,9 @@ void ZGeneration::select_relocation_set(ZGenerationId generation, bool promote_a
   // Flip age young pages that were not selected
   flip_age_pages(&selector);
 
+  // Recycle sparse old pages that were not selected
+  recycle_old_pages(&selector);
+
   // Setup forwarding table
   ZRelocationSetIterator rs_iter(&_relocation_set);
   for (ZForwarding* forwarding; rs_iter.next(&forwarding);) {
@@ -277,11 +291,6 @@ void ZGeneration::reset_relocation_set() {
 
   // Reset relocation set
   _relocation_set.reset(_page_allocator);
-
-  // Reset recyclable page indecies for every age
-  for (uint age = 0; age < ZPageAgeMax + 1; age++) {
-    _r_page_index[age] = 0;
-  }
 }
 
 void ZGeneration::synchronize_relocation() {
@@ -932,8 +941,12 @@ void ZGenerationYoung::relocate() {
   // Relocate relocation set
   _relocate.relocate(&_relocation_set);
 
-  // Update statistics
+  // Recycled pages are no longer relocation targets. Releasing them
+  // accounts for the objects relocated into them, before the statistics.
   _relocation_set.print_all_r_pages();
+  _relocation_set.release_recycled_pages();
+
+  // Update statistics
   stat_heap()->at_relocate_end(_page_allocator->stats(this), should_record_stats());
 }
 
@@ -1394,6 +1407,11 @@ void ZGenerationOld::relocate() {
   // Relocate relocation set
   _relocate.relocate(&_relocation_set);
 
+  // Recycled pages are no longer relocation targets. Releasing them
+  // accounts for the objects relocated into them, before the statistics.
+  _relocation_set.print_all_r_pages();
+  _relocation_set.release_recycled_pages();
+
   // Update statistics
   stat_heap()->at_relocate_end(_page_allocator->stats(this), should_record_stats());
 }
@@ -1524,21 +1542,44 @@ ZGenerationTracer* ZGenerationOld::jfr_tracer() {
   return &_jfr_tracer;
 }
 
-ZPage* ZGeneration::get_next_recyclable_page(ZPageAge age) {
-  ZPage* r = _relocation_set.get_r_page(age, Atomic::fetch_then_add(&_r_page_index[static_cast<uint>(age)], 1u));
-  // log_debug(gc)("GENERATION::GET_NEXT_RECYCLABLE page %p, age %zu, index %zu", (void*)r, (size_t)age, _r_page_index[static_cast<uint>(age)]);
-  if(r != nullptr)
-    return r;
-  else
-    return nullptr;
+ZFreeListAllocatorPool* ZGeneration::free_list_allocators() {
+  return _relocation_set.free_list_allocators();
+}
+
+ZPage* ZGeneration::get_next_recyclable_page(ZPageType type, ZPageAge age, size_t size) {
+  return _relocation_set.claim_recyclable_page(type, age, size);
+}
+
+void ZGeneration::return_recyclable_page(ZPage* page) {
+  _relocation_set.return_recyclable_page(page);
+}
+
+void ZGeneration::register_recycling_failure(ZPageAge age, size_t size) {
+  _relocation_set.register_recycling_failure(age, size);
+}
+
+void ZGeneration::register_relocation_page_allocation(jlong time) {
+  _relocation_set.register_page_allocation(time);
+}
+
+void ZGeneration::register_relocated_sizes(uint type_index, ZPageAge age, const size_t* histogram) {
+  _relocation_set.register_relocated_sizes(type_index, age, histogram);
+}
+
+ZRecyclingPolicy* ZGeneration::recycling_policy() {
+  return _relocation_set.recycling_policy();
 }
 
 void ZGeneration::print_all_r_pages() {
   _relocation_set.print_all_r_pages();
 }
 
-void ZGeneration::register_recycled_pages(const ZArray<ZPage*>& pages) {
+void ZGeneration::register_recycled_pages(const ZArray<ZPendingRecyclablePage>& pages) {
   _relocation_set.register_recycled_pages(pages);
   //statistics
 
+}
+
+bool ZGeneration::build_pending_free_list() {
+  return _relocation_set.build_pending_free_list();
 }
\ No newline at end of file
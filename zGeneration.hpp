@@ -69,7 +69,6 @@ protected:
   ZMark                 _mark;
   ZRelocate             _relocate;
   ZRelocationSet        _relocation_set;
-  size_t                _r_page_index[ZPageAgeMax + 1];
 
   volatile size_t       _freed;
   volatile size_t       _promoted;
@@ -89,6 +88,7 @@ protected:
   void free_empty_pages(ZRelocationSetSelector* selector, int bulk);
   void flip_age_pages(const ZRelocationSetSelector* selector);
   void flip_age_pages(const ZArray<ZPage*>* pages);
+  void recycle_old_pages(const ZRelocationSetSelector* selector);
 
   void mark_free();
 
@@ -174,9 +174,16 @@ public:
   // Threads
   void threads_do(ThreadClosure* tc) const;
 
-  ZPage* get_next_recyclable_page(ZPageAge age);
+  ZFreeListAllocatorPool* free_list_allocators();
+  ZPage* get_next_recyclable_page(ZPageType type, ZPageAge age, size_t size);
+  void return_recyclable_page(ZPage* page);
+  void register_recycling_failure(ZPageAge age, size_t size);
+  void register_relocation_page_allocation(jlong time);
+  void register_relocated_sizes(uint type_index, ZPageAge age, const size_t* histogram);
+  ZRecyclingPolicy* recycling_policy();
   void print_all_r_pages();
-  void register_recycled_pages(const ZArray<ZPage*>& pages);
+  void register_recycled_pages(const ZArray<ZPendingRecyclablePage>& pages);
+  bool build_pending_free_list();
 };
 
 enum class ZYoungType {
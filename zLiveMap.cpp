@@ -29,6 +29,7 @@
 #include "gc/z/zUtils.hpp"
 #include "logging/log.hpp"
 #include "runtime/atomic.hpp"
+#include "utilities/align.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/powerOfTwo.hpp"
 
@@ -40,6 +41,11 @@ static size_t bitmap_size(uint32_t size, size_t nsegments) {
   return MAX2<size_t>(size, nsegments) * 2;
 }
 
+static size_t summary_size(size_t bitmap_size) {
+  // One bit per bitmap word
+  return ZLiveMapSummary ? align_up(bitmap_size, BitsPerWord) / BitsPerWord : 0;
+}
+
 ZLiveMap::ZLiveMap(uint32_t size)
   : _seqnum(0),
     _live_objects(0),
@@ -47,7 +53,8 @@ ZLiveMap::ZLiveMap(uint32_t size)
     _segment_live_bits(0),
     _segment_claim_bits(0),
     _bitmap(bitmap_size(size, nsegments)),
-    _segment_shift(exact_log2(segment_size())) {}
+    _segment_shift(exact_log2(segment_size())),
+    _summary(summary_size(_bitmap.size())) {}
 
 void ZLiveMap::reset(ZGenerationId id) {
   ZGeneration* const generation = ZGeneration::generation(id);
@@ -121,15 +128,40 @@ void ZLiveMap::reset_segment(BitMap::idx_t segment) {
     _bitmap.clear_range(start_index, end_index);
   }
 
+  if (ZLiveMapSummary) {
+    reset_summary(segment);
+  }
+
   // Set live bit
   const bool success = set_segment_live(segment);
   assert(success, "Should never fail");
 }
 
+void ZLiveMap::reset_summary(BitMap::idx_t segment) {
+  if (segment_size() < (BitMap::idx_t)BitsPerWord) {
+    // The segment shares its bitmap word with other segments, which
+    // might be marked concurrently. The summary bit is left set.
+    return;
+  }
+
+  const BitMap::idx_t start_word = segment_start(segment) >> LogBitsPerWord;
+  const BitMap::idx_t end_word = segment_end(segment) >> LogBitsPerWord;
+  if (is_aligned(start_word, BitsPerWord) && is_aligned(end_word, BitsPerWord)) {
+    // The segment has summary words of its own
+    _summary.clear_range(start_word, end_word);
+  } else {
+    // Other segments share the summary words, and might be marked concurrently
+    for (BitMap::idx_t word = start_word; word < end_word; word++) {
+      _summary.par_clear_bit(word);
+    }
+  }
+}
+
 void ZLiveMap::resize(uint32_t size) {
   const size_t new_bitmap_size = bitmap_size(size, nsegments);
   if (_bitmap.size() != new_bitmap_size) {
     _bitmap.reinitialize(new_bitmap_size, false /* clear */);
     _segment_shift = exact_log2(segment_size());
+    _summary.reinitialize(summary_size(new_bitmap_size), false /* clear */);
   }
 }
@@ -45,6 +45,11 @@ private:
   ZBitMap           _bitmap;
   size_t            _segment_shift;
 
+  // With ZLiveMapSummary, one bit per bitmap word, set when a bit in the
+  // word is set. A clear bit means that the word is empty, a set bit only
+  // that it might not be.
+  ZBitMap           _summary;
+
   const BitMapView segment_live_bits() const;
   const BitMapView segment_claim_bits() const;
 
@@ -65,6 +70,10 @@ private:
 
   bool claim_segment(BitMap::idx_t segment);
 
+  void set_summary(BitMap::idx_t index);
+  void reset_summary(BitMap::idx_t segment);
+  BitMap::idx_t next_live_word(BitMap::idx_t word_index, BitMap::idx_t end_word) const;
+
   void reset(ZGenerationId id);
   void reset_segment(BitMap::idx_t segment);
 
@@ -95,6 +104,12 @@ public:
   template <typename Function>
   void iterate_forced(ZGenerationId id, Function function);
 
+  // Visits live objects by scanning the bitmap words directly. The function
+  // gets the bit index of a live object and returns the bit index where the
+  // scan should continue, which lets it skip the bits covered by the object.
+  template <typename Function>
+  void iterate_forced_skipping(Function function);
+
   BitMap::idx_t find_base_bit(BitMap::idx_t index);
   BitMap::idx_t find_base_bit_in_segment(BitMap::idx_t start, BitMap::idx_t index);
 };
@@ -32,7 +32,9 @@
 #include "gc/z/zMark.hpp"
 #include "gc/z/zUtils.inline.hpp"
 #include "runtime/atomic.hpp"
+#include "utilities/align.hpp"
 #include "utilities/bitMap.inline.hpp"
+#include "utilities/count_trailing_zeros.hpp"
 #include "utilities/debug.hpp"
 
 inline void ZLiveMap::reset() {
@@ -87,6 +89,23 @@ inline BitMap::idx_t ZLiveMap::next_live_segment(BitMap::idx_t segment) const {
   return segment_live_bits().find_first_set_bit(segment + 1, nsegments);
 }
 
+inline void ZLiveMap::set_summary(BitMap::idx_t index) {
+  // Iteration happens after marking has completed, or races with the
+  // marking anyway, so the summary bit is not ordered with the bitmap
+  const BitMap::idx_t word = index >> LogBitsPerWord;
+  if (!_summary.par_at(word, memory_order_relaxed)) {
+    _summary.par_set_bit(word, memory_order_relaxed);
+  }
+}
+
+inline BitMap::idx_t ZLiveMap::next_live_word(BitMap::idx_t word_index, BitMap::idx_t end_word) const {
+  if (!ZLiveMapSummary || word_index >= end_word) {
+    return word_index;
+  }
+
+  return _summary.find_first_set_bit(word_index, end_word);
+}
+
 inline BitMap::idx_t ZLiveMap::segment_size() const {
   return _bitmap.size() / nsegments;
 }
@@ -116,7 +135,13 @@ inline bool ZLiveMap::set(ZGenerationId id, BitMap::idx_t index, bool finalizabl
     reset_segment(segment);
   }
 
-  return _bitmap.par_set_bit_pair(index, finalizable, inc_live);
+  const bool success = _bitmap.par_set_bit_pair(index, finalizable, inc_live);
+
+  if (ZLiveMapSummary && success) {
+    set_summary(index);
+  }
+
+  return success;
 }
 
 inline void ZLiveMap::inc_live(uint32_t objects, size_t bytes) {
@@ -147,10 +172,48 @@ template <typename Function>
 inline void ZLiveMap::iterate_segment(BitMap::idx_t segment, Function function) {
   assert(is_segment_live(segment), "Must be");
 
-  const BitMap::idx_t start_index = segment_start(segment);
-  const BitMap::idx_t end_index   = segment_end(segment);
+  // Only the even bits mark the start of a live object, the odd bits are
+  // the finalizable bits, and are not visited. The live bits of a word are
+  // extracted into a buffer before the function is applied to them, so
+  // that the bit scanning loop does not depend on the function.
+  const BitMap::bm_word_t live_bits = (BitMap::bm_word_t)CONST64(0x5555555555555555);
+  const BitMap::bm_word_t* const map = _bitmap.map();
+  const BitMap::idx_t end_index = segment_end(segment);
+  const BitMap::idx_t end_word = align_up(end_index, BitsPerWord) >> LogBitsPerWord;
+  BitMap::idx_t indices[BitsPerWord / 2];
+
+  for (BitMap::idx_t index = segment_start(segment); index < end_index;) {
+    const BitMap::idx_t word_index = next_live_word(index >> LogBitsPerWord, end_word);
+    if (word_index >= end_word) {
+      // No live object in the rest of this segment
+      break;
+    }
 
-  _bitmap.iterate(function, start_index, end_index);
+    if (word_index != index >> LogBitsPerWord) {
+      // Skipped the empty words
+      index = word_index << LogBitsPerWord;
+    }
+
+    const BitMap::idx_t word_start = word_index << LogBitsPerWord;
+    BitMap::bm_word_t word = map[word_index] & live_bits & (~(BitMap::bm_word_t)0 << (index & (BitsPerWord - 1)));
+    if (end_index - word_start < (BitMap::idx_t)BitsPerWord) {
+      // Segments of small live maps end within a word
+      word &= right_n_bits(end_index - word_start);
+    }
+
+    uint nindices = 0;
+    for (; word != 0; word &= word - 1) {
+      indices[nindices++] = word_start + count_trailing_zeros(word);
+    }
+
+    for (uint i = 0; i < nindices; i++) {
+      if (!function(indices[i])) {
+        return;
+      }
+    }
+
+    index = word_start + BitsPerWord;
+  }
 }
 
 template <typename Function>
@@ -159,17 +222,9 @@ inline void ZLiveMap::iterate(ZGenerationId id, Function function) {
     return;
   }
 
-  auto live_only = [&](BitMap::idx_t index) -> bool {
-    if ((index & 1) == 0) {
-      return function(index);
-    }
-    // Don't visit the finalizable bits
-    return true;
-  };
-
   for (BitMap::idx_t segment = first_live_segment(); segment < nsegments; segment = next_live_segment(segment)) {
     // For each live segment
-    iterate_segment(segment, live_only);
+    iterate_segment(segment, function);
   }
 }
 
@@ -179,17 +234,55 @@ inline void ZLiveMap::iterate_forced(ZGenerationId id, Function function) {
   //   return;
   // }
 
-  auto live_only = [&](BitMap::idx_t index) -> bool {
-    if ((index & 1) == 0) {
-      return function(index);
-    }
-    // Don't visit the finalizable bits
-    return true;
-  };
+  for (BitMap::idx_t segment = first_live_segment(); segment < nsegments; segment = next_live_segment(segment)) {
+    // For each live segment
+    iterate_segment(segment, function);
+  }
+}
+
+template <typename Function>
+inline void ZLiveMap::iterate_forced_skipping(Function function) {
+  // Only the even bits mark the start of a live object, the odd
+  // bits are the finalizable bits.
+  const BitMap::bm_word_t live_bits = (BitMap::bm_word_t)CONST64(0x5555555555555555);
+  const BitMap::bm_word_t* const map = _bitmap.map();
+
+  BitMap::idx_t index = 0;
 
   for (BitMap::idx_t segment = first_live_segment(); segment < nsegments; segment = next_live_segment(segment)) {
     // For each live segment
-    iterate_segment(segment, live_only);
+    const BitMap::idx_t end_index = segment_end(segment);
+    const BitMap::idx_t end_word = align_up(end_index, BitsPerWord) >> LogBitsPerWord;
+    index = MAX2(index, segment_start(segment));
+
+    while (index < end_index) {
+      const BitMap::idx_t word_index = next_live_word(index >> LogBitsPerWord, end_word);
+      if (word_index >= end_word) {
+        // No live object in the rest of this segment
+        break;
+      }
+
+      if (word_index != index >> LogBitsPerWord) {
+        // Skipped the empty words
+        index = word_index << LogBitsPerWord;
+      }
+
+      const BitMap::bm_word_t word = map[word_index] & live_bits & (~(BitMap::bm_word_t)0 << (index & (BitsPerWord - 1)));
+
+      if (word == 0) {
+        // No live object in the rest of this word
+        index = (word_index + 1) << LogBitsPerWord;
+        continue;
+      }
+
+      index = (word_index << LogBitsPerWord) + count_trailing_zeros(word);
+      if (index >= end_index) {
+        // Bits past the end of the segment are not valid
+        break;
+      }
+
+      index = function(index);
+    }
   }
 }
 
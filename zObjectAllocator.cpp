@@ -22,9 +22,12 @@
  */
 
 #include "precompiled.hpp"
+#include "gc/shared/tlab_globals.hpp"
+#include "gc/z/zArray.inline.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zHeuristics.hpp"
+#include "gc/z/zLock.inline.hpp"
 #include "gc/z/zObjectAllocator.hpp"
 #include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPageTable.inline.hpp"
@@ -39,6 +42,7 @@
 
 static const ZStatCounter ZCounterUndoObjectAllocationSucceeded("Memory", "Undo Object Allocation Succeeded", ZStatUnitOpsPerSecond);
 static const ZStatCounter ZCounterUndoObjectAllocationFailed("Memory", "Undo Object Allocation Failed", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterRecycledHoleTLAB("Memory", "Recycled Hole TLAB", ZStatUnitOpsPerSecond);
 
 ZObjectAllocator::ZObjectAllocator(ZPageAge age)
   : _age(age),
@@ -46,7 +50,10 @@ ZObjectAllocator::ZObjectAllocator(ZPageAge age)
     _used(0),
     _undone(0),
     _shared_medium_page(nullptr),
-    _shared_small_page(nullptr) {}
+    _shared_small_page(nullptr),
+    _recycled_holes_lock(),
+    _recycled_holes(),
+    _nrecycled_holes(0) {}
 
 ZPage** ZObjectAllocator::shared_small_page_addr() {
   return _use_per_cpu_shared_small_pages ? _shared_small_page.addr() : _shared_small_page.addr(0);
@@ -166,6 +173,64 @@ zaddress ZObjectAllocator::alloc_object(size_t size) {
   return alloc_object(size, flags);
 }
 
+zaddress ZObjectAllocator::alloc_tlab_in_recycled_hole(size_t min_size, size_t requested_size, size_t* actual_size) {
+  if (Atomic::load(&_nrecycled_holes) == 0) {
+    // No holes
+    return zaddress::null;
+  }
+
+  ZLocker<ZLock> locker(&_recycled_holes_lock);
+
+  if (_recycled_holes.is_empty()) {
+    return zaddress::null;
+  }
+
+  ZRecycledHole& hole = _recycled_holes.last();
+  if (hole._size < min_size) {
+    // Leave the hole to threads asking for smaller TLABs
+    return zaddress::null;
+  }
+
+  const zaddress addr = hole._addr;
+  const size_t size = MIN2(hole._size, requested_size);
+
+  if (hole._size - size >= MinTLABSize) {
+    // Keep the rest of the hole for the next TLAB
+    hole._addr = hole._addr + size;
+    hole._size -= size;
+  } else {
+    // The rest of the hole is too small for a TLAB, and is left unused
+    _recycled_holes.pop();
+    Atomic::store(&_nrecycled_holes, (size_t)_recycled_holes.length());
+  }
+
+  // Increment used bytes
+  Atomic::add(_used.addr(), size);
+
+  ZStatInc(ZCounterRecycledHoleTLAB);
+
+  *actual_size = size;
+  return addr;
+}
+
+zaddress ZObjectAllocator::alloc_tlab(size_t min_size, size_t requested_size, size_t* actual_size) {
+  if (ZAllocateTLABsInRecycledPages) {
+    const zaddress addr = alloc_tlab_in_recycled_hole(min_size, requested_size, actual_size);
+    if (!is_null(addr)) {
+      return addr;
+    }
+  }
+
+  *actual_size = requested_size;
+  return alloc_object(requested_size);
+}
+
+void ZObjectAllocator::register_recycled_hole(zaddress addr, size_t size) {
+  ZLocker<ZLock> locker(&_recycled_holes_lock);
+  _recycled_holes.push({addr, size});
+  Atomic::store(&_nrecycled_holes, (size_t)_recycled_holes.length());
+}
+
 zaddress ZObjectAllocator::alloc_object_for_relocation(size_t size) {
   ZAllocationFlags flags;
   flags.set_non_blocking();
@@ -230,4 +295,9 @@ void ZObjectAllocator::retire_pages() {
   // Reset allocation pages
   _shared_medium_page.set(nullptr);
   _shared_small_page.set_all(nullptr);
+
+  // Objects allocated in the holes of recycled pages are not implicitly
+  // live, so the holes must not be used once marking has started
+  _recycled_holes.clear();
+  _nrecycled_holes = 0;
 }
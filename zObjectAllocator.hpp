@@ -26,6 +26,8 @@
 
 #include "gc/z/zAddress.hpp"
 #include "gc/z/zAllocationFlags.hpp"
+#include "gc/z/zArray.hpp"
+#include "gc/z/zLock.hpp"
 #include "gc/z/zPageAge.hpp"
 #include "gc/z/zPageType.hpp"
 #include "gc/z/zValue.hpp"
@@ -33,6 +35,11 @@
 class ZPage;
 class ZPageTable;
 
+struct ZRecycledHole {
+  zaddress _addr;
+  size_t   _size;
+};
+
 class ZObjectAllocator {
 private:
   ZPageAge           _age;
@@ -42,6 +49,12 @@ private:
   ZContended<ZPage*> _shared_medium_page;
   ZPerCPU<ZPage*>    _shared_small_page;
 
+  // Holes in recycled young pages, available to TLABs until the
+  // allocating pages are retired
+  ZLock                 _recycled_holes_lock;
+  ZArray<ZRecycledHole> _recycled_holes;
+  volatile size_t       _nrecycled_holes;
+
   ZPage** shared_small_page_addr();
   ZPage* const* shared_small_page_addr() const;
 
@@ -61,11 +74,17 @@ private:
   zaddress alloc_small_object(size_t size, ZAllocationFlags flags);
   zaddress alloc_object(size_t size, ZAllocationFlags flags);
 
+  zaddress alloc_tlab_in_recycled_hole(size_t min_size, size_t requested_size, size_t* actual_size);
+
 public:
   ZObjectAllocator(ZPageAge age);
 
   // Mutator allocation
   zaddress alloc_object(size_t size);
+  zaddress alloc_tlab(size_t min_size, size_t requested_size, size_t* actual_size);
+
+  // Recycled young pages
+  void register_recycled_hole(zaddress addr, size_t size);
 
   // Relocation
   zaddress alloc_object_for_relocation(size_t size);
@@ -23,18 +23,36 @@
 
 #include "precompiled.hpp"
 #include "gc/shared/gc_globals.hpp"
+#include "gc/z/zArray.inline.hpp"
+#include "gc/z/zFreeListAllocatorPool.hpp"
 #include "gc/z/zGeneration.inline.hpp"
 #include "gc/z/zList.inline.hpp"
+#include "gc/z/zLock.inline.hpp"
 #include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPhysicalMemory.inline.hpp"
 #include "gc/z/zRememberedSet.inline.hpp"
 #include "gc/z/zVirtualMemory.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "utilities/align.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/growableArray.hpp"
+#include "utilities/powerOfTwo.hpp"
 #include <string>
 #include <sstream>
 
+// Number of free ranges handed to a free list allocator at a time
+static const size_t FreeRangeBatchSize = 64;
+
+// The objects relocated into the free list of a recycled page, recorded
+// for ZVerifyRecycledPages. Allocating pages are not marked, and the
+// livemap of other pages only covers them if the page was marked in the
+// cycle, so verification can not rely on the livemap to find them.
+class ZPageRelocatedObjects : public CHeapObj<mtGC> {
+public:
+  ZLock             _lock;
+  ZArray<FreeRange> _objects;
+};
+
 ZPage::ZPage(ZPageType type, const ZVirtualMemory& vmem, const ZPhysicalMemory& pmem)
   : _type(type),
     _generation_id(ZGenerationId::young),
@@ -51,10 +69,14 @@ ZPage::ZPage(ZPageType type, const ZVirtualMemory& vmem, const ZPhysicalMemory&
     _node(),
     _allocator(nullptr),
     _exhausted(false),
+    _aggregated(false),
     _bytes_freed(0),
     _bytes_used(0),
     _failed_relocation_size(0),
-    _free_list_time(0) {
+    _free_list_time(0),
+    _window_top(0),
+    _window_end(0),
+    _relocated_objects(nullptr) {
   assert(!_virtual.is_null(), "Should not be null");
   assert(!_physical.is_null(), "Should not be null");
   assert(_virtual.size() == _physical.size(), "Virtual/Physical size mismatch");
@@ -328,61 +350,131 @@ void ZPage::fatal_msg(const char* msg) const {
   fatal("%s", ss.base());
 }
 
-bool ZPage::init_free_list() {
+bool ZPage::init_free_list(ZFreeListAllocatorPool* pool, size_t min_free_block_size) {
+  return init_free_list(pool, this, min_free_block_size, false /* concurrent */);
+}
+
+bool ZPage::init_free_list(ZFreeListAllocatorPool* pool, ZPage* live_page, size_t min_free_block_size, bool concurrent) {
   _free_list_time = os::elapsed_counter();
-  assert(this->age() != ZPageAge::old, "Cannot construct free lists in old pages");
-  assert(this->type() == ZPageType::small, "Free Lists can only exist in small pages");
+  assert(this->is_small() || this->is_medium(), "Free Lists can only exist in small and medium pages");
+  assert(live_page->type() == type() && live_page->start() == start(), "Liveness information must cover this page");
 
   _failed_relocation_size = 0;
   _exhausted = false;
+  _aggregated = false;
   _bytes_freed = 0;
   _bytes_used = 0;
+  _window_top = 0;
+  _window_end = 0;
+
+  if (ZVerifyRecycledPages) {
+    if (_relocated_objects == nullptr) {
+      _relocated_objects = new ZPageRelocatedObjects();
+    }
+    _relocated_objects->_objects.clear();
+  }
 
   if(_allocator){
     //reset the current allocator, and mark entire page as allocated
     _allocator->reset();
   } else {
-    //create a new allocator
-    _allocator = new ZAllocatorWrapper((void*)ZOffset::address(start()), size(), 0, true, ZUseBuddyAllocator);
+    //check out an allocator for this page, with the entire page allocated
+    _allocator = pool->checkout(free_list_allocator_kind(), (void*)ZOffset::address(start()), size());
   }
 
   //Reconstruct the free list from the livemap
   //
   //Resetting a free list allocator assumes allocating all the
   //space available, and we are reconstructing it by freeing the
-  //spaces inbetween live objects.
-  zaddress curr = ZOffset::address(this->start());
-  auto free_internal_range = [&](BitMap::idx_t idx) -> bool {
-    zaddress addr = ZOffset::address(offset_from_bit_index(idx));
-    size_t free_size = align_down(addr - curr, object_alignment());
-    if(free_size >= (long unsigned int)ZMinFreeBlockSize) {
-      assert(curr >= ZOffset::address(this->start()), "free_range starts before page start");
-      assert(curr + free_size < ZOffset::address(to_zoffset(this->end())), "free_range reaches outside end of page");
-      _allocator->free_range((void*)curr,free_size);
-      _bytes_freed += free_size;
-      // log_debug(gc)("initadr : %p\ninitsiz : %zu", (void*)curr, free_size);
-      // log_debug(gc)("free %d %zu", (int)static_cast<uint>(this->age()), free_size);
+  //spaces inbetween live objects. The gaps are handed to the
+  //allocator in batches.
+  //
+  //Promoted pages are cloned without liveness information, so
+  //the livemap is read from live_page, which is the page the
+  //objects were marked in.
+  //
+  //The gaps of old pages can contain stale remembered set bits
+  //from dead objects. They are cleared before the gap is handed
+  //out, otherwise remembered set scanning could visit non-oop
+  //words of objects relocated into the gap. Mutators can remember
+  //fields of live objects on relocatable pages concurrently, and
+  //the young generation can flip the bitmaps, so both bitmaps are
+  //cleared atomically there. Other old pages were just promoted,
+  //and are not yet visible to the mutators as old pages, unless
+  //the free list is built after they have been registered.
+  const bool clear_remset = is_old();
+  const bool clear_remset_par = clear_remset && (is_relocatable() || concurrent);
+  FreeRange ranges[FreeRangeBatchSize];
+  size_t nranges = 0;
+
+  auto free_internal_range = [&](zaddress from, size_t free_size) {
+    if(free_size < min_free_block_size) {
+      return;
+    }
+    assert(from >= ZOffset::address(this->start()), "free_range starts before page start");
+    assert(from + free_size <= ZOffset::address(to_zoffset(this->end())), "free_range reaches outside end of page");
+    if(clear_remset_par) {
+      clear_remset_range_par(local_offset(from), free_size);
+    } else if(clear_remset) {
+      clear_remset_range_non_par_current(local_offset(from), free_size);
+    }
+    ranges[nranges++] = {(void*)from, free_size};
+    _bytes_freed += free_size;
+    if(nranges == FreeRangeBatchSize) {
+      _allocator->free_ranges(ranges, nranges);
+      nranges = 0;
     }
-    curr = addr + ZUtils::object_size(addr);
-    return true;
   };
 
-  _livemap.iterate_forced(_generation_id, free_internal_range);
+  zaddress curr = ZOffset::address(this->start());
+  auto do_live_object = [&](BitMap::idx_t idx) -> BitMap::idx_t {
+    const zaddress addr = ZOffset::address(offset_from_bit_index(idx));
+    const size_t size = align_up(ZUtils::object_size(addr), object_alignment());
+    free_internal_range(curr, align_down(addr - curr, object_alignment()));
+    curr = addr + size;
+    // No other object can start inside this object
+    return idx + ((size >> object_alignment_shift()) * 2);
+  };
 
-  size_t final_block_size = align_down(ZOffset::address(to_zoffset(end()))-curr, object_alignment());
-  if(final_block_size >= (long unsigned int)ZMinFreeBlockSize) {
-    assert(curr >= ZOffset::address(this->start()), "free_range starts before page start");
-    assert(curr + final_block_size <= ZOffset::address(to_zoffset(end())), "free_range reaches outside end of page");
-    _allocator->free_range((void*)curr, final_block_size);
-    _bytes_freed += final_block_size;
-    // log_debug(gc)("initadr : %p\ninitsiz : %zu", (void*)curr, final_block_size);
-    // log_debug(gc)("free %d %zu", (int)static_cast<uint>(this->age()), final_block_size);
+  live_page->_livemap.iterate_forced_skipping(do_live_object);
+
+  free_internal_range(curr, align_down(ZOffset::address(to_zoffset(end())) - curr, object_alignment()));
+
+  if(nranges > 0) {
+    _allocator->free_ranges(ranges, nranges);
   }
   // log_debug(gc)("FINISHED FREE LIST INITIALIZATION %p",(void*)start());
+  reset_recycling_seqnum();
   _free_list_time = os::elapsed_counter() - _free_list_time;
   return true;
 }
 
+ZFreeListAllocatorKind ZPage::free_list_allocator_kind() const {
+  return free_list_allocator_kind(_type);
+}
+
+ZFreeListAllocatorKind ZPage::free_list_allocator_kind(ZPageType type) {
+  if(type == ZPageType::medium) {
+    // Medium objects are too large for the size classes of the TLSF allocator
+    return ZFreeListAllocatorKind::medium_binary_buddy;
+  }
+  if(ZUseGapBumpAllocator) {
+    // Small recycled pages are only used by one worker at a time
+    return ZFreeListAllocatorKind::gap_bump;
+  }
+  return ZUseBuddyAllocator ? ZFreeListAllocatorKind::binary_buddy : ZFreeListAllocatorKind::tlsf;
+}
+
+void ZPage::release_free_list(ZFreeListAllocatorPool* pool) {
+  if(_allocator != nullptr) {
+    pool->checkin(_allocator);
+    _allocator = nullptr;
+  }
+
+  delete _relocated_objects;
+  _relocated_objects = nullptr;
+}
+
 void ZPage::print_live_addresses() {
   int age = 1;
   if(_age == ZPageAge::old) {
@@ -408,73 +500,259 @@ void ZPage::fill_page() {
   _top = this->end();
 }
 
-zaddress ZPage::alloc_object_free_list(size_t size) {
-  // log_debug(gc)("\nalog page    : %p \
-  //                \nalog top     : %p \
-  //                \nalog start   : %p \
-  //                \nalog end     : %p \
-  //                \nalog offset  : %zu",
-  //                (void*)this,
-  //                (void*)top(),
-  //                (void*)start(),
-  //                (void*)end(),
-  //                size);  
+void ZPage::mark_free_list_object(zaddress addr, size_t size) {
+  if (_relocated_objects != nullptr) {
+    // Medium pages are shared by the relocation workers
+    ZLocker<ZLock> locker(&_relocated_objects->_lock);
+    _relocated_objects->_objects.append({(void*)untype(addr), align_up(size, object_alignment())});
+  }
+
+  if (is_allocating()) {
+    // Objects in allocating pages are implicitly live
+    return;
+  }
+
+  // Old pages recycled by an old collection keep the liveness information
+  // of the cycle, and the young generation trusts it when scanning their
+  // remembered sets. Objects relocated into the free list must be marked,
+  // otherwise their remembered fields would not be visited.
+  bool inc_live = false;
+  mark_object(addr, false /* finalizable */, inc_live);
+  if (inc_live) {
+    _livemap.inc_live(1, align_up(size, object_alignment()));
+  }
+}
+
+zaddress ZPage::take_free_list_block(size_t size) {
+  assert(_allocator != nullptr, "Free list not initialized");
+
+  // The block is handed out of the free list as a whole, and is not
+  // accounted for as used by relocation
+  return to_zaddress((uintptr_t)_allocator->allocate(size));
+}
+
+size_t ZPage::undo_alloc_object_free_list(zaddress addr, size_t size) {
+  assert(_allocator != nullptr, "Free list not initialized");
+  assert(_allocator->allocator_kind() != ZFreeListAllocatorKind::medium_binary_buddy,
+         "Frees are not safe on shared pages");
+
+  // Return the block to the free list, and account for it as free again
   const size_t aligned_size = align_up(size, object_alignment());
-  if(this->type() == ZPageType::small) {
-    // log_debug(gc)("reloc0 %d %zu", (int)static_cast<uint>(this->age()), aligned_size);
+  if (untype(addr) + aligned_size == _window_top) {
+    // The last block bumped in the window
+    _window_top = untype(addr);
+  } else if (has_free_list_window()) {
+    // The block may have been bumped in a window, so it is not aligned the
+    // way the allocator aligns its own blocks. The binary buddy allocator
+    // rounds the size of a freed block up and assumes its alignment, so
+    // the block is returned as a range, trimmed to the free granularity.
+    _allocator->free_range((void*)untype(addr), aligned_size);
+  } else {
+    _allocator->free((void*)untype(addr), aligned_size);
   }
-  assert(!(_recycling_seqnum != generation()->seqnum() || _allocator == nullptr), "called free_list without initializing free list");
-  // if(_recycling_seqnum != generation()->seqnum() || _allocator == nullptr) {
-  //   return alloc_object(size);
-  // }
-  assert(this->age() != ZPageAge::old, "No recycling of Old pages");
-  // assert(false, "yaho");
-
-  // log_debug(gc)("reloc1 %d %zu", (int)static_cast<uint>(this->age()), aligned_size);
-
-  zaddress addr = to_zaddress((uintptr_t)_allocator->allocate(aligned_size));
-  if(is_null(addr)) {
-    // log_debug(gc)("failed %d %zu", (int)static_cast<uint>(this->age()), aligned_size);
-    _exhausted = true;
-    _failed_relocation_size = aligned_size;
-    return zaddress::null;
+  Atomic::sub(&_bytes_used, aligned_size);
+
+  // The freed block may be adjacent to other free blocks
+  _aggregated = false;
+
+  return aligned_size;
+}
+
+void ZPage::retire_free_list_window() {
+  if (_window_top < _window_end) {
+    // Return the unused part of the window
+    _allocator->free_range((void*)_window_top, _window_end - _window_top);
+    _aggregated = false;
   }
 
-  // if((uintptr_t)_top < ((uintptr_t)0x3ffffffffff & ((uintptr_t)addr+aligned_size))) {
-  //   log_debug(gc)("\ntop   : %p\nnewtop: %p", (void*)top(), (void*)to_zoffset_end(ZAddress::offset(addr),aligned_size));
-  // }
-
-  // _top = top() > to_zoffset_end(ZAddress::offset(addr),aligned_size) ?
-  //   top() :
-  //   to_zoffset_end(ZAddress::offset(addr),aligned_size);
-  // log_debug(gc)("\nlive objects: %d \
-                 \nalloc addr  : %p \
-                 \nsize        : %zu \
-                 \nnew top     : %p \
-                 \nthis        : %p \
-                 \n----------- \
-                 \n", live_objects(), (void*)addr, aligned_size , (void*)_top, (void*)this);
-  if((void*)addr != nullptr) {
-    // log_debug(gc)("recycle %d %zu", (int)static_cast<uint>(this->age()), aligned_size);
+  _window_top = 0;
+  _window_end = 0;
+}
+
+bool ZPage::aggregate_free_list() {
+  if (_allocator == nullptr || _aggregated) {
+    // Nothing was freed since the last aggregation
+    return false;
   }
-  _bytes_used += aligned_size;  
 
-  return addr;
+  // Coalescing changes the free blocks, so earlier allocation
+  // failures no longer bound the largest free block
+  _allocator->aggregate();
+  _aggregated = true;
+  Atomic::store(&_exhausted, false);
+  Atomic::store(&_failed_relocation_size, (size_t)0);
+  return true;
 }
 
 bool ZPage::exhausted() {
-  return _exhausted;
+  return Atomic::load(&_exhausted);
 }
 
 size_t ZPage::bytes_freed() {
   return _bytes_freed;
 }
 size_t ZPage::bytes_used() {
-  return _bytes_used;
+  return Atomic::load(&_bytes_used);
+}
+size_t ZPage::free_list_free_bytes() {
+  return _bytes_freed - bytes_used();
 }
 size_t ZPage::failed_relocation_size() {
-  return _failed_relocation_size;
+  return Atomic::load(&_failed_relocation_size);
 }
 jlong ZPage::get_free_list_time() {
   return _free_list_time;
+}
+
+size_t ZPage::free_list_metadata_size() const {
+  return _allocator != nullptr ? _allocator->metadata_size() : 0;
+}
+
+size_t ZPage::free_list_largest_block() {
+  if(_allocator == nullptr) {
+    return 0;
+  }
+
+  // A failed allocation also bounds the largest free block. This guarantees
+  // that a page is not handed out again for an object that did not fit it.
+  const size_t largest = _allocator->largest_free_block();
+  const size_t failed = failed_relocation_size();
+  return failed != 0 ? MIN2(largest, failed - object_alignment()) : largest;
+}
+
+static void collect_free_list_block(void* blocks, void* start, size_t size) {
+  static_cast<ZArray<FreeRange>*>(blocks)->append({start, size});
+}
+
+static int compare_free_list_blocks(FreeRange* block1, FreeRange* block2) {
+  if (block1->start == block2->start) {
+    return 0;
+  }
+  return block1->start < block2->start ? -1 : 1;
+}
+
+template <typename Function>
+void ZPage::verify_free_list_blocks(Function live_objects_do, bool exact, size_t min_free_block_size) {
+  guarantee(_allocator != nullptr, "Free list not initialized");
+
+  ZArray<FreeRange> blocks;
+  _allocator->free_blocks_do(collect_free_list_block, &blocks);
+  blocks.sort(compare_free_list_blocks);
+
+  const uintptr_t page_start = untype(ZOffset::address(start()));
+  const size_t granularity = _allocator->free_granularity();
+  int next = 0;
+
+  // Consumes the free blocks before 'to', which must all be inside the hole
+  // [from, to). Directly after initialization, the free blocks must also
+  // cover the hole exactly as init_free_list() offered it, trimmed to the
+  // granularity of the allocator.
+  auto verify_hole = [&](uintptr_t from, uintptr_t to) {
+    size_t free_bytes = 0;
+    for (; next < blocks.length() && (uintptr_t)blocks.at(next).start < to; next++) {
+      const uintptr_t block_start = (uintptr_t)blocks.at(next).start;
+      const uintptr_t block_end = block_start + blocks.at(next).size;
+      guarantee(block_start >= from && block_end <= to,
+                "Free block [" PTR_FORMAT ", " PTR_FORMAT ") overlaps a live object or another free block, page " PTR_FORMAT,
+                block_start, block_end, page_start);
+      free_bytes += blocks.at(next).size;
+      from = block_end;
+    }
+
+    if (!exact) {
+      return;
+    }
+
+    const size_t hole_size = align_down(to - from, object_alignment());
+    const uintptr_t offered_start = align_up(from, granularity);
+    const uintptr_t offered_end = align_down(from + hole_size, granularity);
+    const size_t expected = (hole_size >= min_free_block_size && offered_end > offered_start) ? offered_end - offered_start : 0;
+    guarantee(free_bytes == expected,
+              "Hole [" PTR_FORMAT ", " PTR_FORMAT ") has " SIZE_FORMAT " free bytes, expected " SIZE_FORMAT ", page " PTR_FORMAT,
+              from, to, free_bytes, expected, page_start);
+  };
+
+  uintptr_t curr = page_start;
+  live_objects_do([&](zaddress addr, size_t size) {
+    verify_hole(curr, untype(addr));
+    curr = untype(addr) + size;
+  });
+  verify_hole(curr, untype(ZOffset::address(to_zoffset(end()))));
+
+  guarantee(next == blocks.length(), "Free block outside of page " PTR_FORMAT, page_start);
+}
+
+void ZPage::verify_free_list(ZPage* live_page, size_t min_free_block_size) {
+  // Walks the livemap the same way as init_free_list()
+  auto live_objects_do = [&](auto function) {
+    live_page->_livemap.iterate_forced_skipping([&](BitMap::idx_t index) -> BitMap::idx_t {
+      const zaddress addr = ZOffset::address(offset_from_bit_index(index));
+      const size_t size = align_up(ZUtils::object_size(addr), object_alignment());
+      function(addr, size);
+      return index + ((size >> object_alignment_shift()) * 2);
+    });
+  };
+
+  verify_free_list_blocks(live_objects_do, true /* exact */, min_free_block_size);
+}
+
+void ZPage::verify_free_list_after_relocation() {
+  guarantee(_relocated_objects != nullptr, "Relocated objects not recorded");
+
+  // Blocks have been handed out, so only overlaps can be verified, against
+  // the objects relocated into the page and, if the page is marked, its
+  // livemap. Allocating pages, such as flip-aged and flip-promoted pages,
+  // are not marked, so for those only the relocated objects are covered.
+  ZArray<FreeRange> objects;
+  object_iterate([&](oop obj) {
+    const zaddress addr = to_zaddress(obj);
+    objects.append({(void*)untype(addr), align_up(ZUtils::object_size(addr), object_alignment())});
+  });
+  for (const FreeRange& object : _relocated_objects->_objects) {
+    objects.append(object);
+  }
+  objects.sort(compare_free_list_blocks);
+
+  auto live_objects_do = [&](auto function) {
+    void* prev = nullptr;
+    for (const FreeRange& object : objects) {
+      if (object.start == prev) {
+        // Relocated objects are also in the livemap of marked pages
+        continue;
+      }
+      function(to_zaddress((uintptr_t)object.start), object.size);
+      prev = object.start;
+    }
+  };
+
+  verify_free_list_blocks(live_objects_do, false /* exact */, 0 /* min_free_block_size */);
+}
+
+void ZPage::print_free_list_fragmentation(outputStream* out) {
+  if (_allocator == nullptr) {
+    return;
+  }
+
+  ZArray<FreeRange> blocks;
+  _allocator->free_blocks_do(collect_free_list_block, &blocks);
+
+  // Number of free blocks per power of two size class
+  size_t histogram[BitsPerWord] = {};
+  size_t free_bytes = 0;
+  size_t largest = 0;
+
+  for (const FreeRange& block : blocks) {
+    histogram[log2i(block.size)]++;
+    free_bytes += block.size;
+    largest = MAX2(largest, block.size);
+  }
+
+  out->print("Recycled %s Page " PTR_FORMAT ": " SIZE_FORMAT " free in %d blocks, largest " SIZE_FORMAT,
+             type_to_string(), untype(ZOffset::address(start())), free_bytes, blocks.length(), largest);
+  for (int i = 0; i < BitsPerWord; i++) {
+    if (histogram[i] != 0) {
+      out->print(", " SIZE_FORMAT ":" SIZE_FORMAT, (size_t)1 << i, histogram[i]);
+    }
+  }
+  out->cr();
 }
\ No newline at end of file
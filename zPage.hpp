@@ -36,6 +36,7 @@
 #include "gc/z/zVirtualMemory.hpp"
 #include "memory/allocation.hpp"
 
+class ZFreeListAllocatorPool;
 class ZGeneration;
 
 enum class ZPageResetType {
@@ -50,6 +51,8 @@ enum class ZPageResetType {
   Splitting,
 };
 
+class ZPageRelocatedObjects;
+
 class ZPage : public CHeapObj<mtGC> {
   friend class VMStructs;
   friend class ZList<ZPage>;
@@ -72,10 +75,14 @@ private:
   ZListNode<ZPage>                      _node;
   ZAllocatorWrapper*                    _allocator;
   bool                                  _exhausted;
+  bool                                  _aggregated;
   size_t                                _bytes_freed;
   size_t                                _bytes_used;
   size_t                                _failed_relocation_size;
   jlong                                 _free_list_time;
+  uintptr_t                             _window_top;
+  uintptr_t                             _window_end;
+  ZPageRelocatedObjects*                _relocated_objects;
 
   ZPageType type_from_size(size_t size) const;
   const char* type_to_string() const;
@@ -96,7 +103,17 @@ private:
 
   void verify_remset_after_reset(ZPageAge prev_age, ZPageResetType type);
 
+  template <typename Function>
+  void verify_free_list_blocks(Function live_objects_do, bool exact, size_t min_free_block_size);
+
+  bool has_free_list_window() const;
+  template <typename Allocator>
+  void* alloc_free_list_block(size_t aligned_size);
+
 public:
+  // Max number of objects allocated by one alloc_objects_free_list() call
+  static const size_t free_list_batch_max = 16;
+
   ZPage(ZPageType type, const ZVirtualMemory& vmem, const ZPhysicalMemory& pmem);
 
   void reset_seqnum();
@@ -180,6 +197,7 @@ public:
   // In-place relocation support
   void clear_remset_bit_non_par_current(uintptr_t l_offset);
   void clear_remset_range_non_par_current(uintptr_t l_offset, size_t size);
+  void clear_remset_range_par(uintptr_t l_offset, size_t size);
   void swap_remset_bitmaps();
 
   void remset_clear();
@@ -214,7 +232,17 @@ public:
 
   zaddress alloc_object(size_t size);
   zaddress alloc_object_atomic(size_t size);
+  // The free list allocator must be of the kind of the page, see
+  // free_list_allocator_kind(ZPageType)
+  template <typename Allocator>
   zaddress alloc_object_free_list(size_t size);
+  template <typename Allocator>
+  size_t alloc_objects_free_list(const size_t* sizes, zaddress* addrs, size_t count);
+  void mark_free_list_object(zaddress addr, size_t size);
+  bool aggregate_free_list();
+  void retire_free_list_window();
+  zaddress take_free_list_block(size_t size);
+  size_t undo_alloc_object_free_list(zaddress addr, size_t size);
 
   bool undo_alloc_object(zaddress addr, size_t size);
   bool undo_alloc_object_atomic(zaddress addr, size_t size);
@@ -232,14 +260,26 @@ public:
 
   void fatal_msg(const char* msg) const;
 
-  bool init_free_list();
+  ZFreeListAllocatorKind free_list_allocator_kind() const;
+  static ZFreeListAllocatorKind free_list_allocator_kind(ZPageType type);
+  bool init_free_list(ZFreeListAllocatorPool* pool, size_t min_free_block_size);
+  bool init_free_list(ZFreeListAllocatorPool* pool, ZPage* live_page, size_t min_free_block_size, bool concurrent);
+  void release_free_list(ZFreeListAllocatorPool* pool);
   void fill_page();
   void print_live_addresses();
   bool exhausted();
   size_t bytes_freed();
   size_t bytes_used();
+  size_t free_list_free_bytes();
   size_t failed_relocation_size();
   jlong get_free_list_time();
+  size_t free_list_metadata_size() const;
+  size_t free_list_largest_block();
+
+  // Verification of the free list against the livemap
+  void verify_free_list(ZPage* live_page, size_t min_free_block_size);
+  void verify_free_list_after_relocation();
+  void print_free_list_fragmentation(outputStream* out);
 };
 
 class ZPageClosure {
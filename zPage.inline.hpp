@@ -26,6 +26,7 @@
 
 #include "gc/z/zPage.hpp"
 
+#include "gc/z/AllocatorWrapper.inline.hpp"
 #include "gc/z/zAddress.inline.hpp"
 #include "gc/z/zGeneration.inline.hpp"
 #include "gc/z/zGlobals.hpp"
@@ -41,6 +42,7 @@
 #include "utilities/align.hpp"
 #include "utilities/checkedCast.hpp"
 #include "utilities/debug.hpp"
+#include "utilities/powerOfTwo.hpp"
 
 inline ZPageType ZPage::type_from_size(size_t size) const {
   if (size == ZPageSizeSmall) {
@@ -370,6 +372,11 @@ inline void ZPage::clear_remset_range_non_par_current(uintptr_t l_offset, size_t
   _remembered_set.unset_range_non_par_current(l_offset, size);
 }
 
+inline void ZPage::clear_remset_range_par(uintptr_t l_offset, size_t size) {
+  _remembered_set.unset_range_par_current(l_offset, size);
+  _remembered_set.unset_range_par_previous(l_offset, size);
+}
+
 inline ZBitMap::ReverseIterator ZPage::remset_reverse_iterator_previous() {
   return _remembered_set.iterator_reverse_previous();
 }
@@ -504,6 +511,100 @@ inline zaddress ZPage::alloc_object_atomic(size_t size) {
   }
 }
 
+inline bool ZPage::has_free_list_window() const {
+  // Small recycled pages are only used by one worker at a time,
+  // so the window can be bumped without synchronization
+  return ZRecycledLocalityWindowSize > 0 && is_small();
+}
+
+template <typename Allocator>
+inline void* ZPage::alloc_free_list_block(size_t aligned_size) {
+  if (!has_free_list_window()) {
+    return _allocator->as<Allocator>()->allocate(aligned_size);
+  }
+
+  if (_window_end - _window_top >= aligned_size) {
+    // Adjacent to the previous object
+    const uintptr_t addr = _window_top;
+    _window_top += aligned_size;
+    return (void*)addr;
+  }
+
+  // Carve a new window from the free list. The free list allocators do not
+  // place blocks in address order, so objects that are relocated together
+  // would otherwise be scattered over the page.
+  retire_free_list_window();
+
+  size_t window_size = MAX2(aligned_size, align_up(ZRecycledLocalityWindowSize, object_alignment()));
+  if (_allocator->allocator_kind() == ZFreeListAllocatorKind::binary_buddy) {
+    // The binary buddy allocator hands out power of two blocks. The window
+    // covers the whole block, otherwise the rounded up tail would neither
+    // be bumped nor returned when the window is retired.
+    window_size = round_up_power_of_2(MAX2(window_size, _allocator->free_granularity()));
+  }
+  void* const window = _allocator->as<Allocator>()->allocate(window_size);
+  if (window == nullptr) {
+    // No hole is large enough for a window
+    return _allocator->as<Allocator>()->allocate(aligned_size);
+  }
+
+  _window_top = (uintptr_t)window + aligned_size;
+  _window_end = (uintptr_t)window + window_size;
+  return window;
+}
+
+template <typename Allocator>
+inline zaddress ZPage::alloc_object_free_list(size_t size) {
+  assert(_recycling_seqnum == generation()->seqnum() && _allocator != nullptr, "Free list not initialized");
+
+  // The page can be shared by several relocation workers, so the
+  // bookkeeping below is updated atomically.
+  const size_t aligned_size = align_up(size, object_alignment());
+  const zaddress addr = to_zaddress((uintptr_t)alloc_free_list_block<Allocator>(aligned_size));
+  if (is_null(addr)) {
+    Atomic::store(&_exhausted, true);
+    Atomic::store(&_failed_relocation_size, aligned_size);
+    return zaddress::null;
+  }
+
+  Atomic::add(&_bytes_used, aligned_size);
+
+  return addr;
+}
+
+template <typename Allocator>
+inline size_t ZPage::alloc_objects_free_list(const size_t* sizes, zaddress* addrs, size_t count) {
+  assert(_allocator != nullptr, "Free list not initialized");
+  assert(count <= free_list_batch_max, "Too many objects");
+
+  size_t aligned_sizes[free_list_batch_max];
+  void* blocks[free_list_batch_max];
+  for (size_t i = 0; i < count; i++) {
+    aligned_sizes[i] = align_up(sizes[i], object_alignment());
+  }
+
+  // Allocates the longest prefix of the objects that fits. The first object
+  // that did not fit is left to alloc_object_free_list(), which records the
+  // failure.
+  size_t allocated = 0;
+  if (has_free_list_window()) {
+    while (allocated < count && (blocks[allocated] = alloc_free_list_block<Allocator>(aligned_sizes[allocated])) != nullptr) {
+      allocated++;
+    }
+  } else {
+    allocated = _allocator->as<Allocator>()->allocate_many(aligned_sizes, blocks, count);
+  }
+
+  size_t allocated_bytes = 0;
+  for (size_t i = 0; i < allocated; i++) {
+    addrs[i] = to_zaddress((uintptr_t)blocks[i]);
+    allocated_bytes += aligned_sizes[i];
+  }
+  Atomic::add(&_bytes_used, allocated_bytes);
+
+  return allocated;
+}
+
 inline bool ZPage::undo_alloc_object(zaddress addr, size_t size) {
   assert(is_allocating(), "Invalid state");
   return false;
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#include "precompiled.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zRecyclingPolicy.hpp"
+#include "gc/z/zStat.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/timer.hpp"
+#include "utilities/formatBuffer.hpp"
+
+// Bounds of the adaptive thresholds, relative to the flags
+static const double MinMaximumLiveFraction = 0.1;
+static const size_t MaxMinFreeBlockSizeFactor = 16;
+
+// Thresholds for the hole utilization of the last cycles
+static const double LowUtilization = 0.5;
+static const double HighUtilization = 0.9;
+
+static double min_maximum_live() {
+  return ZRecycleMaximumLive * MinMaximumLiveFraction;
+}
+
+static size_t max_min_free_block_size() {
+  return (size_t)ZMinFreeBlockSize * MaxMinFreeBlockSizeFactor;
+}
+
+ZRecyclingPolicy::ZRecyclingPolicy(const char* name)
+  : _name(name),
+    _maximum_live(),
+    _min_free_block_size(),
+    _utilization(),
+    _cost(),
+    _saved(),
+    _failures(),
+    _free_list_time(),
+    _page_allocation_time(),
+    _min_object_size() {
+  for (uint i = 0; i <= ZPageAgeMax; i++) {
+    _maximum_live[i] = ZRecycleMaximumLive;
+    _min_free_block_size[i] = (size_t)ZMinFreeBlockSize;
+  }
+}
+
+double ZRecyclingPolicy::maximum_live(ZPageAge age) const {
+  return ZAdaptiveRecycling ? _maximum_live[static_cast<uint>(age)] : ZRecycleMaximumLive;
+}
+
+uint ZRecyclingPolicy::type_index(ZPageType type) {
+  assert(type == ZPageType::small || type == ZPageType::medium, "Invalid page type for recycling");
+  return type == ZPageType::small ? 0 : 1;
+}
+
+size_t ZRecyclingPolicy::min_free_block_size(ZPageType type, ZPageAge age) const {
+  if (!ZAdaptiveRecycling) {
+    return (size_t)ZMinFreeBlockSize;
+  }
+
+  const uint i = static_cast<uint>(age);
+  return MAX2(_min_free_block_size[i], _min_object_size[type_index(type)][i]);
+}
+
+bool ZRecyclingPolicy::should_recycle(ZPage* page, ZPageAge to_age) const {
+  if (!page->is_small() && !(page->is_medium() && ZRecycleMediumPages)) {
+    return false;
+  }
+
+  if (to_age == ZPageAge::old && !ZRecycleOldPages) {
+    return false;
+  }
+
+  return page->live_objects() > 0 &&
+         page->live_bytes() < maximum_live(to_age) * page->size();
+}
+
+double ZRecyclingPolicy::hole_utilization(ZPageAge age) const {
+  const uint i = static_cast<uint>(age);
+  return _utilization[i].num() > 0 ? clamp(_utilization[i].davg(), 0.0, 1.0) : 0.0;
+}
+
+bool ZRecyclingPolicy::should_keep_as_target(ZPage* page, ZPageAge to_age) const {
+  if (!should_recycle(page, to_age)) {
+    return false;
+  }
+
+  const uint i = static_cast<uint>(to_age);
+  if (_utilization[i].num() == 0) {
+    // Nothing to base the estimate on
+    return false;
+  }
+
+  // Relocating the page copies its live bytes, and reclaims all of it.
+  // Keeping it copies nothing, and the objects relocated into its holes
+  // need no new pages, but the holes that are not used are not reclaimed.
+  const double utilization = hole_utilization(to_age);
+  const size_t live = page->live_bytes();
+  const size_t holes = page->size() - live;
+  if ((1.0 - utilization) * holes >= live) {
+    return false;
+  }
+
+  // The free list construction must also be cheaper than allocating
+  // the pages that the used holes replace
+  if (_page_allocation_time.num() > 0 && _free_list_time[i].num() > 0) {
+    const double saved = utilization * holes / page->size() * _page_allocation_time.davg();
+    if (_free_list_time[i].davg() > saved) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ZRecyclingPolicy::set_thresholds(ZPageAge age, double maximum_live, size_t min_free_block_size, const char* reason) {
+  const uint i = static_cast<uint>(age);
+
+  maximum_live = clamp(maximum_live, min_maximum_live(), (double)ZRecycleMaximumLive);
+  min_free_block_size = clamp(min_free_block_size, (size_t)ZMinFreeBlockSize, max_min_free_block_size());
+
+  if (maximum_live == _maximum_live[i] && min_free_block_size == _min_free_block_size[i]) {
+    // No change
+    return;
+  }
+
+  FormatBuffer<> age_str("");
+  if (age == ZPageAge::old) {
+    age_str.append("Old");
+  } else {
+    age_str.append("Survivor %d", i);
+  }
+
+  log_debug(gc, reloc)("Recycling Policy (%s, %s): Maximum Live %.0f%% -> %.0f%%, Minimum Free Block " SIZE_FORMAT "B -> " SIZE_FORMAT "B, %s",
+                       _name, age_str.buffer(),
+                       _maximum_live[i] * 100.0, maximum_live * 100.0,
+                       _min_free_block_size[i], min_free_block_size,
+                       reason);
+
+  _maximum_live[i] = maximum_live;
+  _min_free_block_size[i] = min_free_block_size;
+}
+
+void ZRecyclingPolicy::update_relocated_sizes(ZPageType type, ZPageAge age, const size_t* histogram) {
+  size_t nobjects = 0;
+  for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+    nobjects += histogram[size_class];
+  }
+
+  // Holes smaller than the 1st percentile of the relocated object sizes
+  // are unlikely to be used, and are not worth constructing
+  size_t min_object_size = 0;
+  size_t nsmaller = 0;
+  for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes && nobjects > 0; size_class++) {
+    nsmaller += histogram[size_class];
+    if (nsmaller * 100 >= nobjects) {
+      min_object_size = (size_t)1 << size_class;
+      break;
+    }
+  }
+
+  _min_object_size[type_index(type)][static_cast<uint>(age)] = min_object_size;
+}
+
+void ZRecyclingPolicy::update_page_allocation_time(double page_allocation_time) {
+  if (page_allocation_time > 0.0) {
+    _page_allocation_time.add(page_allocation_time);
+  }
+}
+
+void ZRecyclingPolicy::update(ZPageAge age, const ZStatRecyclingSummary& summary) {
+  const uint i = static_cast<uint>(age);
+  const double maximum_live = _maximum_live[i];
+  const size_t min_free_block_size = _min_free_block_size[i];
+
+  if (summary.npages == 0) {
+    if (!ZAdaptiveRecycling) {
+      return;
+    }
+
+    // Nothing was recycled, relax the thresholds so that pages are
+    // considered again when the object size mix changes
+    set_thresholds(age, maximum_live * 1.25, min_free_block_size / 2, "No pages recycled");
+    return;
+  }
+
+  size_t nfailures = 0;
+  for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+    nfailures += summary.nfailures[size_class];
+  }
+
+  // The time spent constructing free lists is weighed against the time
+  // the relocation workers would have spent allocating the avoided pages.
+  // The avoided pages are the consumed bytes in fractions of a page, as
+  // in should_keep_as_target(), so that low volume cycles are not counted
+  // as saving nothing.
+  _utilization[i].add(summary.offered > 0 ? (double)summary.consumed / summary.offered : 0.0);
+  _cost[i].add(TimeHelper::counter_to_seconds(summary.free_list_time));
+  _saved[i].add(summary.npages_avoided * _page_allocation_time.davg());
+  _failures[i].add((double)nfailures / summary.npages);
+  _free_list_time[i].add(TimeHelper::counter_to_seconds(summary.free_list_time) / summary.npages);
+
+  if (!ZAdaptiveRecycling) {
+    // The outcome is still recorded for the relocation set selection
+    return;
+  }
+
+  if (_page_allocation_time.num() > 0 && _cost[i].davg() > _saved[i].davg()) {
+    // Recycle fewer, sparser pages, with fewer holes to construct
+    set_thresholds(age, maximum_live * 0.75, min_free_block_size * 2, "Free list construction costs more than the page allocations saved");
+  } else if (_utilization[i].davg() < LowUtilization) {
+    // More holes are offered than relocation consumes
+    set_thresholds(age, maximum_live * 0.9, min_free_block_size * 2, "Low hole utilization");
+  } else if (_utilization[i].davg() > HighUtilization && _failures[i].davg() > 1.0) {
+    // Relocation runs out of holes, offer more of them
+    set_thresholds(age, maximum_live * 1.1, min_free_block_size / 2, "High hole utilization");
+  }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+
+#ifndef SHARE_GC_Z_ZRECYCLINGPOLICY_HPP
+#define SHARE_GC_Z_ZRECYCLINGPOLICY_HPP
+
+#include "gc/z/zPageAge.hpp"
+#include "gc/z/zPageType.hpp"
+#include "utilities/globalDefinitions.hpp"
+#include "utilities/numberSeq.hpp"
+
+class ZPage;
+struct ZStatRecyclingSummary;
+
+// Thresholds used when recycling pages of an age. With ZAdaptiveRecycling,
+// the maximum live fraction of a recycled page, and the minimum size of the
+// free blocks in its free list, are adjusted after each cycle from the
+// recycling outcome of the last cycles. Otherwise ZRecycleMaximumLive and
+// ZMinFreeBlockSize are used as is. Adaptive free lists also drop the holes
+// that are smaller than the smallest relocated objects of the last cycle.
+class ZRecyclingPolicy {
+private:
+  const char*  _name;
+  double       _maximum_live[ZPageAgeMax + 1];
+  size_t       _min_free_block_size[ZPageAgeMax + 1];
+  TruncatedSeq _utilization[ZPageAgeMax + 1];
+  TruncatedSeq _cost[ZPageAgeMax + 1];
+  TruncatedSeq _saved[ZPageAgeMax + 1];
+  TruncatedSeq _failures[ZPageAgeMax + 1];
+  TruncatedSeq _free_list_time[ZPageAgeMax + 1];
+  TruncatedSeq _page_allocation_time;
+  size_t       _min_object_size[2][ZPageAgeMax + 1];
+
+  static uint type_index(ZPageType type);
+
+  void set_thresholds(ZPageAge age, double maximum_live, size_t min_free_block_size, const char* reason);
+
+public:
+  ZRecyclingPolicy(const char* name);
+
+  double maximum_live(ZPageAge age) const;
+  size_t min_free_block_size(ZPageType type, ZPageAge age) const;
+
+  bool should_recycle(ZPage* page, ZPageAge to_age) const;
+
+  // Hole utilization of the recycled pages of an age in the last cycles,
+  // or 0 if no pages of the age have been recycled
+  double hole_utilization(ZPageAge age) const;
+
+  // Whether a page that could be relocated is better kept as a recycling
+  // target, given the hole utilization and free list construction time
+  // of the last cycles
+  bool should_keep_as_target(ZPage* page, ZPageAge to_age) const;
+
+  // Average time of a relocation target page allocation in the cycle,
+  // shared by all ages. Called once per cycle, before update().
+  void update_page_allocation_time(double page_allocation_time);
+  void update(ZPageAge age, const ZStatRecyclingSummary& summary);
+  void update_relocated_sizes(ZPageType type, ZPageAge age, const size_t* histogram);
+};
+
+#endif // SHARE_GC_Z_ZRECYCLINGPOLICY_HPP
@@ -47,10 +47,13 @@
 #include "gc/z/zWorkers.hpp"
 #include "prims/jvmtiTagMap.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "runtime/prefetch.inline.hpp"
 #include "utilities/debug.hpp"
 
 static const ZStatCriticalPhase ZCriticalPhaseRelocationStall("Relocation Stall");
 static const ZStatSubPhase ZSubPhaseConcurrentRelocateRememberedSetFlipPromotedYoung("Concurrent Relocate Remset FP", ZGenerationId::young);
+static const ZStatCounter ZCounterUndoFreeListAllocation("Memory", "Undo Free List Allocation", ZStatUnitBytesPerSecond);
 
 static uintptr_t forwarding_index(ZForwarding* forwarding, zoffset from_offset) {
   return (from_offset - forwarding->start()) >> forwarding->object_alignment_shift();
@@ -430,7 +433,7 @@ static ZPage* revive_page(ZPage* target) {
   return target;
 }
 
-static ZPage* alloc_page(ZAllocatorForRelocation* allocator, ZPageType type, size_t size) {
+static ZPage* alloc_page(ZGeneration* generation, ZAllocatorForRelocation* allocator, ZPageType type, size_t size) {
   if (ZStressRelocateInPlace) {
     // Simulate failure to allocate a new page. This will
     // cause the page being relocated to be relocated in-place.
@@ -441,7 +444,12 @@ static ZPage* alloc_page(ZAllocatorForRelocation* allocator, ZPageType type, siz
   flags.set_non_blocking();
   flags.set_gc_relocation();
 
-  return allocator->alloc_page_for_relocation(type, size, flags);
+  // The allocation time is what recycling saves for each avoided page
+  const jlong start = os::elapsed_counter();
+  ZPage* const page = allocator->alloc_page_for_relocation(type, size, flags);
+  generation->register_relocation_page_allocation(os::elapsed_counter() - start);
+
+  return page;
 }
 
 static void retire_target_page(ZGeneration* generation, ZPage* page) {
@@ -460,34 +468,49 @@ static void retire_target_page(ZGeneration* generation, ZPage* page) {
   }
 }
 
+static void retire_recycled_target_page(ZGeneration* generation, ZPage* page) {
+  // Hand the page back, so that its remaining free blocks can be used for
+  // objects that fit them. The objects relocated into recycled pages are
+  // accounted for when the recycled pages are released.
+  generation->return_recyclable_page(page);
+}
+
 class ZRelocateSmallAllocator {
 private:
   ZGeneration* const _generation;
   volatile size_t    _in_place_count;
+  volatile size_t    _aggregated_count;
+
+  void retire_recycled_page(ZPage* page) {
+    page->retire_free_list_window();
+
+    if (ZAggregateRetiredFreeLists) {
+      // The page is still only used by this worker, so its free
+      // list can be coalesced before other workers can claim it
+      page->aggregate_free_list();
+    }
+
+    retire_recycled_target_page(_generation, page);
+  }
 
 public:
   ZRelocateSmallAllocator(ZGeneration* generation)
     : _generation(generation),
-      _in_place_count(0) {}
+      _in_place_count(0),
+      _aggregated_count(0) {}
 
-  ZPage* revive_and_retire_target_page(ZForwarding* forwarding, ZPage* target) {
-    ZPage* page = revive_page(_generation->get_next_recyclable_page(forwarding->to_age()));
-    
-    if(page != nullptr) {
-      // page->print_live_addresses();
-    }
-
-    if (page != nullptr && target != nullptr) {
-      // Retire the old target page
-      retire_target_page(_generation, target);
+  ZPage* revive_and_retire_target_page(ZForwarding* forwarding, ZPage* target, size_t size) {
+    if (target != nullptr) {
+      // Retire the old recycled target page
+      retire_recycled_page(target);
     }
 
-    return page;
+    return revive_page(_generation->get_next_recyclable_page(forwarding->type(), forwarding->to_age(), size));
   }
 
   ZPage* alloc_and_retire_target_page(ZForwarding* forwarding, ZPage* target) {
     ZAllocatorForRelocation* const allocator = ZAllocator::relocation(forwarding->to_age());
-    ZPage* const page = alloc_page(allocator, forwarding->type(), forwarding->size());
+    ZPage* const page = alloc_page(_generation, allocator, forwarding->type(), forwarding->size());
     if (page == nullptr) {
       Atomic::inc(&_in_place_count);
     }
@@ -510,21 +533,68 @@ public:
     }
   }
 
+  void free_recycled_target_page(ZPage* page) {
+    if (page != nullptr) {
+      retire_recycled_page(page);
+    }
+  }
+
   zaddress alloc_object(ZPage* page, size_t size) const {
     return (page != nullptr) ? page->alloc_object(size) : zaddress::null;
   }
 
-  zaddress alloc_object_free_list(ZPage* page, size_t size) const {
-    return (page != nullptr) ? page->alloc_object_free_list(size) : zaddress::null;
+  bool can_alloc_object_free_list(size_t size) const {
+    return size <= ZMaxRelocationInFreeLists;
+  }
+
+  template <typename FreeList>
+  zaddress alloc_object_free_list(ZPage* page, size_t size) {
+    if (page == nullptr) {
+      return zaddress::null;
+    }
+
+    const zaddress addr = page->alloc_object_free_list<FreeList>(size);
+    if (!is_null(addr) || !ZAggregateFreeLists) {
+      return addr;
+    }
+
+    // The free blocks are fragmented if the allocation failed although the
+    // free bytes would fit the object. Small recycled pages are only used by
+    // one worker at a time, so the free list can be coalesced and retried.
+    if (page->free_list_free_bytes() < align_up(size, page->object_alignment()) || !page->aggregate_free_list()) {
+      return zaddress::null;
+    }
+
+    const zaddress aggregated_addr = page->alloc_object_free_list<FreeList>(size);
+    if (!is_null(aggregated_addr)) {
+      // Rescued by the aggregation
+      Atomic::inc(&_aggregated_count);
+    }
+    return aggregated_addr;
+  }
+
+  template <typename FreeList>
+  size_t alloc_objects_free_list(ZPage* page, const size_t* sizes, zaddress* addrs, size_t count) {
+    return page->alloc_objects_free_list<FreeList>(sizes, addrs, count);
   }
 
   void undo_alloc_object(ZPage* page, zaddress addr, size_t size) const {
     page->undo_alloc_object(addr, size);
   }
 
+  void undo_alloc_object_free_list(ZPage* page, zaddress addr, size_t size) const {
+    // Small recycled pages are only used by one worker at a time,
+    // so the block can be returned to the free list
+    ZStatInc(ZCounterUndoFreeListAllocation, page->undo_alloc_object_free_list(addr, size));
+  }
+
   size_t in_place_count() const {
     return _in_place_count;
   }
+
+  size_t aggregated_count() const {
+    return _aggregated_count;
+  }
 };
 
 class ZRelocateMediumAllocator {
@@ -532,22 +602,29 @@ private:
   ZGeneration* const _generation;
   ZConditionLock     _lock;
   ZPage*             _shared[ZAllocator::_relocation_allocators];
+  ZPage*             _shared_recycled[ZAllocator::_relocation_allocators];
   bool               _in_place;
   volatile size_t    _in_place_count;
+  volatile size_t    _recycled_count;
 
 public:
   ZRelocateMediumAllocator(ZGeneration* generation)
     : _generation(generation),
       _lock(),
       _shared(),
+      _shared_recycled(),
       _in_place(false),
-      _in_place_count(0) {}
+      _in_place_count(0),
+      _recycled_count(0) {}
 
   ~ZRelocateMediumAllocator() {
     for (uint i = 0; i < ZAllocator::_relocation_allocators; ++i) {
       if (_shared[i] != nullptr) {
         retire_target_page(_generation, _shared[i]);
       }
+      if (_shared_recycled[i] != nullptr) {
+        retire_recycled_target_page(_generation, _shared_recycled[i]);
+      }
     }
   }
 
@@ -559,9 +636,32 @@ public:
     _shared[static_cast<uint>(age) - 1] = page;
   }
 
-  ZPage* revive_and_retire_target_page(ZForwarding* forwarding, ZPage* target) {
-    //alloc_and_retire_target_page(forwarding, target); //TODO implement for medium
-    return nullptr;
+  ZPage* shared_recycled(ZPageAge age) {
+    return _shared_recycled[static_cast<uint>(age) - 1];
+  }
+
+  void set_shared_recycled(ZPageAge age, ZPage* page) {
+    _shared_recycled[static_cast<uint>(age) - 1] = page;
+  }
+
+  ZPage* revive_and_retire_target_page(ZForwarding* forwarding, ZPage* target, size_t size) {
+    ZLocker<ZConditionLock> locker(&_lock);
+
+    // Revive a new page only if the shared recycled page is the same as
+    // the current recycled target page. The shared recycled page will be
+    // different if another thread already revived a new page.
+    const ZPageAge to_age = forwarding->to_age();
+    if (shared_recycled(to_age) == target) {
+      // This thread is responsible for retiring the shared recycled page
+      if (target != nullptr) {
+        retire_recycled_target_page(_generation, target);
+      }
+
+      ZPage* const to_page = revive_page(_generation->get_next_recyclable_page(forwarding->type(), to_age, size));
+      set_shared_recycled(to_age, to_page);
+    }
+
+    return shared_recycled(to_age);
   }
 
   ZPage* alloc_and_retire_target_page(ZForwarding* forwarding, ZPage* target) {
@@ -579,7 +679,7 @@ public:
     const ZPageAge to_age = forwarding->to_age();
     if (shared(to_age) == target) {
       ZAllocatorForRelocation* const allocator = ZAllocator::relocation(forwarding->to_age());
-      ZPage* const to_page = alloc_page(allocator, forwarding->type(), forwarding->size());
+      ZPage* const to_page = alloc_page(_generation, allocator, forwarding->type(), forwarding->size());
       set_shared(to_age, to_page);
       if (to_page == nullptr) {
         Atomic::inc(&_in_place_count);
@@ -613,24 +713,60 @@ public:
     // Does nothing
   }
 
+  void free_recycled_target_page(ZPage* page) {
+    // Does nothing
+  }
+
   zaddress alloc_object(ZPage* page, size_t size) const {
     return (page != nullptr) ? page->alloc_object_atomic(size) : zaddress::null;
   }
 
-  zaddress alloc_object_free_list(ZPage* page, size_t size) const {
-    return alloc_object(page, size); // Free list not supported for medium
+  bool can_alloc_object_free_list(size_t size) const {
+    return ZRecycleMediumPages;
+  }
+
+  template <typename FreeList>
+  zaddress alloc_object_free_list(ZPage* page, size_t size) {
+    // The free list allocator supports concurrent allocations,
+    // so the recycled page can be shared by all workers. This
+    // also means that its free list is never aggregated.
+    const zaddress addr = (page != nullptr) ? page->alloc_object_free_list<FreeList>(size) : zaddress::null;
+    if (!is_null(addr)) {
+      // Relocated without using a new medium page
+      Atomic::inc(&_recycled_count);
+    }
+    return addr;
+  }
+
+  template <typename FreeList>
+  size_t alloc_objects_free_list(ZPage* page, const size_t* sizes, zaddress* addrs, size_t count) {
+    // Blocks reserved for a batch could not be returned if the objects
+    // are relocated by someone else, see undo_alloc_object_free_list()
+    return 0;
   }
 
   void undo_alloc_object(ZPage* page, zaddress addr, size_t size) const {
     page->undo_alloc_object_atomic(addr, size);
   }
 
+  void undo_alloc_object_free_list(ZPage* page, zaddress addr, size_t size) const {
+    // The buddy allocator does not support frees concurrently with the
+    // allocations of the other workers sharing the page, so the block is
+    // left unused until the free list is reconstructed
+  }
+
   size_t in_place_count() const {
     return _in_place_count;
   }
+
+  size_t recycled_count() const {
+    return _recycled_count;
+  }
 };
 
-template <typename Allocator>
+// FreeList is the free list allocator of the recycled pages that the
+// relocated pages are relocated into, see ZPage::free_list_allocator_kind()
+template <typename Allocator, typename FreeList>
 class ZRelocateWork : public StackObj {
 private:
   Allocator* const   _allocator;
@@ -640,6 +776,11 @@ private:
   ZGeneration* const _generation;
   size_t             _other_promoted;
   size_t             _other_compacted;
+  size_t             _relocated_sizes[ZRelocationSet::nrecyclable_types][ZPageAgeMax + 1][ZStatRecyclingSummary::nsize_classes];
+  zaddress           _reserved_from[ZPage::free_list_batch_max];
+  zaddress           _reserved[ZPage::free_list_batch_max];
+  size_t             _nreserved;
+  size_t             _next_reserved;
 
   ZPage* target(ZPageAge age) {
     return _target[static_cast<uint>(age) - 1];
@@ -661,6 +802,59 @@ private:
     return (size_t)1 << _forwarding->object_alignment_shift();
   }
 
+  void increase_relocated_size(size_t size) {
+    const uint type = ZRelocationSet::recyclable_type_index(_forwarding->type());
+    const uint age = static_cast<uint>(_forwarding->to_age());
+    const uint size_class = MIN2((uint)log2i(size), ZStatRecyclingSummary::nsize_classes - 1);
+    _relocated_sizes[type][age][size_class]++;
+  }
+
+  void flush_relocated_sizes() {
+    for (uint type = 0; type < ZRelocationSet::nrecyclable_types; type++) {
+      for (uint age = 0; age <= ZPageAgeMax; age++) {
+        _generation->register_relocated_sizes(type, static_cast<ZPageAge>(age), _relocated_sizes[type][age]);
+      }
+    }
+  }
+
+  void reserve_free_list_objects(const oop* objs, size_t count) {
+    assert(_next_reserved == _nreserved, "Reservations left over");
+    _nreserved = 0;
+    _next_reserved = 0;
+
+    ZPage* const to_page = recycle_target(_forwarding->to_age());
+    if (to_page == nullptr || count < 2) {
+      // Nothing to batch
+      return;
+    }
+
+    // Reserve blocks for the leading objects that fit the free list. The
+    // objects are relocated in the same order, and claim their blocks in
+    // try_relocate_object_inner().
+    size_t sizes[ZPage::free_list_batch_max];
+    size_t nsizes = 0;
+    for (; nsizes < count; nsizes++) {
+      const zaddress from_addr = to_zaddress(objs[nsizes]);
+      const size_t size = ZUtils::object_size(from_addr);
+      if (!_allocator->can_alloc_object_free_list(size)) {
+        break;
+      }
+      sizes[nsizes] = size;
+      _reserved_from[nsizes] = from_addr;
+    }
+
+    if (nsizes > 0) {
+      _nreserved = _allocator->template alloc_objects_free_list<FreeList>(to_page, sizes, _reserved, nsizes);
+    }
+  }
+
+  zaddress claim_reserved(zaddress from_addr) {
+    if (_next_reserved < _nreserved && _reserved_from[_next_reserved] == from_addr) {
+      return _reserved[_next_reserved++];
+    }
+    return zaddress::null;
+  }
+
   void increase_other_forwarded(size_t unaligned_object_size) {
     const size_t aligned_size = align_up(unaligned_object_size, object_alignment());
     if (_forwarding->is_promotion()) {
@@ -681,19 +875,27 @@ private:
       const zaddress to_addr = forwarding_find(_forwarding, from_addr, &cursor);
       if (!is_null(to_addr)) {
         // Already relocated
+        const zaddress reserved_addr = claim_reserved(from_addr);
+        if (!is_null(reserved_addr)) {
+          _allocator->undo_alloc_object_free_list(recycle_target(_forwarding->to_age()), reserved_addr, size);
+        }
         increase_other_forwarded(size);
         return to_addr;
       }
     }
 
     // Allocate object
-    zaddress allocated_addr; 
+    zaddress allocated_addr = claim_reserved(from_addr);
     
     ZPage* to_page = recycle_target(_forwarding->to_age());
-    if(to_page != nullptr && size <= ZMaxRelocationInFreeLists) {
+    const bool free_list = to_page != nullptr && _allocator->can_alloc_object_free_list(size);
+    if (!is_null(allocated_addr)) {
+      // Reserved by the batch
+      assert(free_list, "Reserved in the recycle target");
+    } else if(free_list) {
       //Try to relocate into a free list if the object
       //is small enough
-      allocated_addr = _allocator->alloc_object_free_list(to_page,size);
+      allocated_addr = _allocator->template alloc_object_free_list<FreeList>(to_page, size);
     } else {
       //If no free list available, or the object is
       //too large, use a new page with bump pointer
@@ -703,9 +905,20 @@ private:
   
     if (is_null(allocated_addr)) {
       // Allocation failed
+      if (free_list) {
+        _generation->register_recycling_failure(_forwarding->to_age(), size);
+      }
       return zaddress::null;
     }
 
+    if (free_list && ZPrefetchRelocation) {
+      // The holes of recycled pages are scattered over previously used
+      // memory, which the hardware prefetcher does not stream in like a
+      // fresh page. The next object most likely follows this one in the
+      // same hole.
+      Prefetch::write((void*)untype(allocated_addr + size), 0);
+    }
+
 
     // Copy object. Use conjoint copying if we are relocating
     // in-place and the new object overlaps with the old object.
@@ -719,8 +932,17 @@ private:
     const zaddress to_addr = forwarding_insert(_forwarding, from_addr, allocated_addr, &cursor);
     if (to_addr != allocated_addr) {
       // Already relocated, undo allocation
-      _allocator->undo_alloc_object(to_page, to_addr, size);
+      if (free_list) {
+        _allocator->undo_alloc_object_free_list(to_page, allocated_addr, size);
+      } else {
+        _allocator->undo_alloc_object(to_page, allocated_addr, size);
+      }
       increase_other_forwarded(size);
+    } else {
+      if (free_list) {
+        to_page->mark_free_list_object(to_addr, size);
+      }
+      increase_relocated_size(size);
     }
 
     return to_addr;
@@ -963,8 +1185,8 @@ private:
       const ZPageAge to_age = _forwarding->to_age();
       // Revive an page and use it as a target, if there are no
       // pages left to choose from, try allocating a new target page
-      if(to_age != ZPageAge::old && size <= ZMaxRelocationInFreeLists) {
-        to_page = _allocator->revive_and_retire_target_page(_forwarding, target(to_age));
+      if(_allocator->can_alloc_object_free_list(size)) {
+        to_page = _allocator->revive_and_retire_target_page(_forwarding, recycle_target(to_age), size);
         set_recycle_target(to_age, to_page);
         if (to_page != nullptr) {
           continue;
@@ -988,6 +1210,18 @@ private:
     }
   }
 
+  void relocate_objects(const oop* objs, size_t count) {
+    reserve_free_list_objects(objs, count);
+
+    // The reserved objects are relocated first, so the recycle target
+    // is not replaced before all reservations have been claimed
+    for (size_t i = 0; i < count; i++) {
+      relocate_object(objs[i]);
+    }
+
+    assert(_next_reserved == _nreserved, "Unclaimed reservations");
+  }
+
 public:
   ZRelocateWork(Allocator* allocator, ZGeneration* generation)
     : _allocator(allocator),
@@ -996,12 +1230,19 @@ public:
       _recycle_target(),
       _generation(generation),
       _other_promoted(0),
-      _other_compacted(0) {}
+      _other_compacted(0),
+      _relocated_sizes(),
+      _reserved_from(),
+      _reserved(),
+      _nreserved(0),
+      _next_reserved(0) {}
 
   ~ZRelocateWork() {
     for (uint i = 0; i < ZAllocator::_relocation_allocators; ++i) {
       _allocator->free_target_page(_target[i]);
+      _allocator->free_recycled_target_page(_recycle_target[i]);
     }
+    flush_relocated_sizes();
     // Report statistics on-behalf of non-worker threads
     _generation->increase_promoted(_other_promoted);
     _generation->increase_compacted(_other_compacted);
@@ -1078,8 +1319,23 @@ public:
 
     ZVerify::before_relocation(_forwarding);
 
-    // Relocate objects
-    _forwarding->object_iterate([&](oop obj) { relocate_object(obj); });
+    // Relocate objects in batches of live objects. The free list blocks
+    // of a batch are allocated together, and with prefetching, the objects
+    // of a batch are prefetched as they are found, before they are copied.
+    const size_t batch_size = ZRelocationBatchSize;
+    oop batch[ZPage::free_list_batch_max];
+    size_t nbatch = 0;
+    _forwarding->object_iterate([&](oop obj) {
+      if (ZPrefetchRelocation) {
+        Prefetch::read(obj, 0);
+      }
+      batch[nbatch++] = obj;
+      if (nbatch == batch_size) {
+        relocate_objects(batch, nbatch);
+        nbatch = 0;
+      }
+    });
+    relocate_objects(batch, nbatch);
 
     ZVerify::after_relocation(_forwarding);
 
@@ -1169,6 +1425,7 @@ private:
   ZRelocateQueue* const          _queue;
   ZRelocateSmallAllocator        _small_allocator;
   ZRelocateMediumAllocator       _medium_allocator;
+  volatile uint                  _nrelocating;
 
 public:
   ZRelocateTask(ZRelocationSet* relocation_set, ZRelocateQueue* queue)
@@ -1177,18 +1434,20 @@ public:
       _generation(relocation_set->generation()),
       _queue(queue),
       _small_allocator(_generation),
-      _medium_allocator(_generation) {}
+      _medium_allocator(_generation),
+      _nrelocating(0) {}
 
   ~ZRelocateTask() {
-    _generation->stat_relocation()->at_relocate_end(_small_allocator.in_place_count(), _medium_allocator.in_place_count());
+    _generation->stat_relocation()->at_relocate_end(_small_allocator.in_place_count(), _medium_allocator.in_place_count(), _medium_allocator.recycled_count(), _small_allocator.aggregated_count());
 
     // Signal that we're not using the queue anymore. Used mostly for asserts.
     _queue->deactivate();
   }
 
-  virtual void work() {
-    ZRelocateWork<ZRelocateSmallAllocator> small(&_small_allocator, _generation);
-    ZRelocateWork<ZRelocateMediumAllocator> medium(&_medium_allocator, _generation);
+  template <typename SmallFreeList>
+  void do_work() {
+    ZRelocateWork<ZRelocateSmallAllocator, SmallFreeList> small(&_small_allocator, _generation);
+    ZRelocateWork<ZRelocateMediumAllocator, ZMediumBuddyAllocator> medium(&_medium_allocator, _generation);
 
     const auto do_forwarding = [&](ZForwarding* forwarding) {
       ZPage* const page = forwarding->page();
@@ -1225,6 +1484,9 @@ public:
       return false;
     };
 
+    Atomic::inc(&_nrelocating);
+    bool done = false;
+
     for (;;) {
       // As long as there are requests in the relocate queue, there are threads
       // waiting in a VM state that does not allow them to be blocked. The
@@ -1237,6 +1499,7 @@ public:
       
       if (!do_forwarding_one_from_iter()) {
         // No more work
+        done = true;
         break;
       }
 
@@ -1245,7 +1508,33 @@ public:
       }
     }
 
+    Atomic::dec(&_nrelocating);
     _queue->leave();
+
+    if (done) {
+      // Workers that have run out of pages to relocate build the pending
+      // free lists, which the workers that are still relocating can claim.
+      // The free lists of the pages that are left are never needed.
+      while (Atomic::load(&_nrelocating) > 0 && _generation->build_pending_free_list()) {}
+    }
+  }
+
+  virtual void work() {
+    // The free list allocator of a page only depends on the page type,
+    // so it is dispatched on once per task, and not on every allocation
+    switch (ZPage::free_list_allocator_kind(ZPageType::small)) {
+    case ZFreeListAllocatorKind::tlsf:
+      do_work<ZTLSFAllocator>();
+      break;
+    case ZFreeListAllocatorKind::binary_buddy:
+      do_work<ZinaryBuddyAllocator>();
+      break;
+    case ZFreeListAllocatorKind::gap_bump:
+      do_work<ZGapBumpAllocator>();
+      break;
+    default:
+      ShouldNotReachHere();
+    }
   }
 
   virtual void resize_workers(uint nworkers) {
@@ -1355,7 +1644,7 @@ public:
   virtual void work() {
     SuspendibleThreadSetJoiner sts_joiner;
     ZArray<ZPage*> promoted_pages;
-    ZArray<ZPage*> recyclable_pages;
+    ZArray<ZPendingRecyclablePage> recyclable_pages;
 
     for (ZPage* prev_page; _iter.next(&prev_page);) {
       const ZPageAge from_age = prev_page->age();
@@ -1379,18 +1668,18 @@ public:
       prev_page->log_msg(promotion ? " (flip promoted)" : " (flip survived)");
 
       // Setup to-space page
+      const bool recycle = ZGeneration::young()->recycling_policy()->should_recycle(prev_page, to_age);
       ZPage* const new_page = promotion ? prev_page->clone_limited_promote_flipped() : prev_page;
-      if(new_page->type() == ZPageType::small && 
-         to_age != ZPageAge::old && 
-         new_page->live_objects() > 0 &&
-         new_page->live_bytes() < ZRecycleMaximumLive*new_page->size()) {
-        //This page should now definitely be eligible for a free list
-        new_page->fill_page(); 
-        new_page->init_free_list();
-        recyclable_pages.push(new_page);
-      }
       new_page->reset(to_age, ZPageResetType::FlipAging);
 
+      if (recycle) {
+        // This page should now definitely be eligible for a free list. Promoted
+        // pages are cloned without liveness information, so the free list is
+        // built from the livemap of the previous page.
+        const size_t min_free_block_size = ZGeneration::young()->recycling_policy()->min_free_block_size(new_page->type(), to_age);
+        recyclable_pages.push({new_page, prev_page, min_free_block_size});
+      }
+
       if (promotion) {
         ZGeneration::young()->flip_promote(prev_page, new_page);
         // Defer promoted page registration times the lock is taken
@@ -1403,7 +1692,6 @@ public:
 
     ZGeneration::young()->register_flip_promoted(promoted_pages);
     ZGeneration::young()->register_recycled_pages(recyclable_pages);
-    // ZGeneration::old()->register_recycled_pages(recyclable_pages);
   }
 };
 
@@ -1412,6 +1700,42 @@ void ZRelocate::flip_age_pages(const ZArray<ZPage*>* pages) {
   workers()->run(&flip_age_task);
 }
 
+class ZRecycleOldPagesTask : public ZTask {
+private:
+  ZArrayParallelIterator<ZPage*> _iter;
+
+public:
+  ZRecycleOldPagesTask(const ZArray<ZPage*>* pages)
+    : ZTask("ZRecycleOldPagesTask"),
+      _iter(pages) {}
+
+  virtual void work() {
+    SuspendibleThreadSetJoiner sts_joiner;
+    ZArray<ZPendingRecyclablePage> recyclable_pages;
+
+    for (ZPage* page; _iter.next(&page);) {
+      assert(page->is_old(), "invalid age for an old collection");
+
+      if (ZGeneration::old()->recycling_policy()->should_recycle(page, ZPageAge::old)) {
+        // The page keeps its objects and liveness information, and the
+        // space between the live objects becomes the free list
+        page->log_msg(" (recycled)");
+        const size_t min_free_block_size = ZGeneration::old()->recycling_policy()->min_free_block_size(page->type(), ZPageAge::old);
+        recyclable_pages.push({page, page, min_free_block_size});
+      }
+
+      SuspendibleThreadSet::yield();
+    }
+
+    ZGeneration::old()->register_recycled_pages(recyclable_pages);
+  }
+};
+
+void ZRelocate::recycle_old_pages(const ZArray<ZPage*>* pages) {
+  ZRecycleOldPagesTask recycle_old_task(pages);
+  workers()->run(&recycle_old_task);
+}
+
 void ZRelocate::synchronize() {
   _queue.synchronize();
 }
@@ -99,6 +99,7 @@ public:
   void relocate(ZRelocationSet* relocation_set);
 
   void flip_age_pages(const ZArray<ZPage*>* pages);
+  void recycle_old_pages(const ZArray<ZPage*>* pages);
 
   void synchronize();
   void desynchronize();
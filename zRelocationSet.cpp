@@ -22,6 +22,8 @@
  */
 
 #include "precompiled.hpp"
+#include "gc/shared/tlab_globals.hpp"
+#include "gc/z/zAllocator.inline.hpp"
 #include "gc/z/zArray.inline.hpp"
 #include "gc/z/zCollectedHeap.hpp"
 #include "gc/z/zForwarding.inline.hpp"
@@ -33,9 +35,66 @@
 #include "gc/z/zRelocationSetSelector.inline.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zTask.hpp"
+#include "gc/z/zValue.inline.hpp"
+#include "gc/z/zVerify.hpp"
 #include "gc/z/zWorkers.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/timer.hpp"
+#include "utilities/align.hpp"
 #include "utilities/debug.hpp"
+#include "utilities/powerOfTwo.hpp"
+
+static const ZStatCounter ZCounterRecycledPages("Memory", "Recycled Pages", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterRecycledOffered("Memory", "Recycled Bytes Offered", ZStatUnitBytesPerSecond);
+static const ZStatCounter ZCounterRecycledConsumed("Memory", "Recycled Bytes Consumed", ZStatUnitBytesPerSecond);
+static const ZStatCounter ZCounterRecyclingFailure("Memory", "Recycling Allocation Failure", ZStatUnitOpsPerSecond);
+static const ZStatSampler ZSamplerFreeListConstruction("Memory", "Free List Construction", ZStatUnitTime);
+
+// Number of recyclable pages a worker claims from the shared pages at a time
+static const int RecyclablePageBatchSize = 4;
+
+// Recyclable pages claimed by a relocation worker. The worker claims
+// its target pages from here first, so that it only needs to take the
+// shared recycling lock once per batch. Other workers steal from the
+// cache when the shared pages have run out.
+class ZRecyclablePageCache {
+private:
+  ZLock                   _lock;
+  ZArray<ZRecyclablePage> _pages[ZRelocationSet::nrecyclable_types][ZPageAgeMax + 1];
+
+public:
+  ZRecyclablePageCache()
+    : _lock(),
+      _pages() {}
+
+  void add(uint type_index, uint age_index, ZRecyclablePage page) {
+    ZLocker<ZLock> locker(&_lock);
+    _pages[type_index][age_index].append(page);
+  }
+
+  ZPage* claim(uint type_index, uint age_index, size_t size) {
+    ZLocker<ZLock> locker(&_lock);
+
+    ZArray<ZRecyclablePage>* const pages = &_pages[type_index][age_index];
+    for (int i = pages->length() - 1; i >= 0; i--) {
+      const ZRecyclablePage available = pages->at(i);
+      if (available._largest_free_block >= size) {
+        pages->delete_at(i);
+        return available._page;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void clear() {
+    for (uint type = 0; type < ZRelocationSet::nrecyclable_types; type++) {
+      for (uint age = 0; age < ZPageAgeMax + 1; age++) {
+        _pages[type][age].clear();
+      }
+    }
+  }
+};
 
 class ZRelocationSetInstallTask : public ZTask {
 private:
@@ -146,7 +205,17 @@ ZRelocationSet::ZRelocationSet(ZGeneration* generation)
     _flip_promoted_pages(),
     _in_place_relocate_promoted_pages(),
     _recyclable_pages(),
-    _nrecyclable_pages() {}
+    _nrecyclable_pages(),
+    _available_pages(),
+    _pending_pages(),
+    _recyclable_caches(),
+    _nrecycling_failures(),
+    _page_allocation_time(0),
+    _npage_allocations(0),
+    _relocated_sizes(),
+    _recycling_active(false),
+    _recycling_policy(generation->is_young() ? "Young" : "Old"),
+    _free_list_allocators() {}
 
 ZWorkers* ZRelocationSet::workers() const {
   return _generation->workers();
@@ -167,6 +236,7 @@ void ZRelocationSet::install(const ZRelocationSetSelector* selector) {
 
   _forwardings = task.forwardings();
   _nforwardings = task.nforwardings();
+  _recycling_active = true;
 
   // Update statistics
   _generation->stat_relocation()->at_install_relocation_set(_allocator.size());
@@ -190,16 +260,174 @@ void ZRelocationSet::reset(ZPageAllocator* page_allocator) {
 
   _nforwardings = 0;
 
-  // Reset recyclable pages
-  for (uint age = 0; age < ZPageAgeMax+1; age++) {
-    _recyclable_pages[age].clear();
-    _nrecyclable_pages[age] = 0;
-  }
+  // Reset recyclable pages, if relocation didn't already release them
+  release_recycled_pages();
+  _free_list_allocators.trim();
 
   destroy_and_clear(page_allocator, &_in_place_relocate_promoted_pages);
   destroy_and_clear(page_allocator, &_flip_promoted_pages);
 }
 
+void ZRelocationSet::release_recycled_pages() {
+  // Return the free list allocators of the recyclable pages. This is done as
+  // soon as relocation has completed, since recycled old pages are owned by
+  // the old generation, which can free them before this relocation set is reset.
+  ZStatRecyclingSummary summary[ZPageAgeMax + 1] = {};
+
+  for (uint type = 0; type < nrecyclable_types; type++) {
+    for (uint age = 0; age < ZPageAgeMax+1; age++) {
+      ZVerify::recycled_pages(_recyclable_pages[type][age]);
+
+      for (ZPage* const page : _recyclable_pages[type][age]) {
+        // Only the objects relocated into the free list of a recycled page are
+        // new, the rest of the page was already in use before relocation started.
+        // Pages can be handed out several times, so they are accounted for here.
+        if (_generation->is_young() && page->is_old()) {
+          _generation->increase_promoted(page->bytes_used());
+        } else {
+          _generation->increase_compacted(page->bytes_used());
+        }
+
+        ZStatRecyclingSummary& age_summary = summary[static_cast<uint>(page->age())];
+        age_summary.npages++;
+        age_summary.offered += page->bytes_freed();
+        age_summary.consumed += page->bytes_used();
+        age_summary.nexhausted += page->exhausted() ? 1 : 0;
+        age_summary.free_list_time += page->get_free_list_time();
+        // The relocated bytes would otherwise have needed new pages of the same
+        // type. Counted in fractions of pages, so that ages and page types that
+        // consumed less than a page are not counted as nothing.
+        age_summary.npages_avoided += (double)page->bytes_used() / page->size();
+
+        ZStatSample(ZSamplerFreeListConstruction, page->get_free_list_time());
+
+        if (ZAllocateTLABsInRecycledPages && _generation->is_young() && _generation->is_phase_relocate() &&
+            page->is_small() && page->age() != ZPageAge::old) {
+          register_recycled_holes(page);
+        }
+
+        page->release_free_list(&_free_list_allocators);
+      }
+
+      _recyclable_pages[type][age].clear();
+      _nrecyclable_pages[type][age] = 0;
+
+      for (uint bucket = 0; bucket < nrecyclable_buckets; bucket++) {
+        _available_pages[type][age][bucket].clear();
+      }
+
+      // Pages whose free lists were never needed are left as they are
+      _pending_pages[type][age].clear();
+    }
+  }
+
+  ZPerWorkerIterator<ZRecyclablePageCache> iter(&_recyclable_caches);
+  for (ZRecyclablePageCache* cache; iter.next(&cache);) {
+    cache->clear();
+  }
+
+  // Report the recycling outcome. This is called again when the relocation
+  // set is reset, at which point the pages have already been released.
+  for (uint age = 0; age <= ZPageAgeMax; age++) {
+    ZStatRecyclingSummary& age_summary = summary[age];
+    for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+      age_summary.nfailures[size_class] = Atomic::load(&_nrecycling_failures[age][size_class]);
+      Atomic::store(&_nrecycling_failures[age][size_class], (size_t)0);
+    }
+
+    if (age_summary.npages == 0) {
+      continue;
+    }
+
+    ZStatInc(ZCounterRecycledPages, age_summary.npages);
+    ZStatInc(ZCounterRecycledOffered, age_summary.offered);
+    ZStatInc(ZCounterRecycledConsumed, age_summary.consumed);
+    _generation->stat_relocation()->at_release_recycled_pages(static_cast<ZPageAge>(age), age_summary);
+  }
+
+  if (!_recycling_active) {
+    // Already released after relocation
+    return;
+  }
+
+  _recycling_active = false;
+
+  // Feed the outcome of the cycle to the recycling policy, including the
+  // ages without recycled pages. The old generation only recycles old pages.
+  const size_t npage_allocations = Atomic::load(&_npage_allocations);
+  const double page_allocation_time = npage_allocations > 0
+      ? TimeHelper::counter_to_seconds(Atomic::load(&_page_allocation_time)) / npage_allocations
+      : 0.0;
+  Atomic::store(&_page_allocation_time, (jlong)0);
+  Atomic::store(&_npage_allocations, (size_t)0);
+  _recycling_policy.update_page_allocation_time(page_allocation_time);
+
+  for (uint age = static_cast<uint>(ZPageAge::survivor1); age <= ZPageAgeMax; age++) {
+    if (_generation->is_old() && age != static_cast<uint>(ZPageAge::old)) {
+      continue;
+    }
+
+    _recycling_policy.update(static_cast<ZPageAge>(age), summary[age]);
+  }
+
+  // Hand the merged object size histograms of the relocation workers to
+  // the statistics and to the recycling policy
+  for (uint type = 0; type < nrecyclable_types; type++) {
+    const ZPageType page_type = (type == recyclable_type_index(ZPageType::small)) ? ZPageType::small : ZPageType::medium;
+    for (uint age = 0; age <= ZPageAgeMax; age++) {
+      size_t histogram[ZStatRecyclingSummary::nsize_classes];
+      for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+        histogram[size_class] = Atomic::load(&_relocated_sizes[type][age][size_class]);
+        Atomic::store(&_relocated_sizes[type][age][size_class], (size_t)0);
+      }
+
+      _generation->stat_relocation()->at_relocated_sizes(page_type, static_cast<ZPageAge>(age), histogram);
+      _recycling_policy.update_relocated_sizes(page_type, static_cast<ZPageAge>(age), histogram);
+    }
+  }
+}
+
+void ZRelocationSet::register_recycled_holes(ZPage* page) {
+  // The holes that relocation left in surviving young pages are handed to
+  // eden, which carves TLABs from them until the next young collection
+  // retires the allocating pages at mark start. Objects allocated in the
+  // holes take the age of the page.
+  const size_t max_size = ZHeap::heap()->max_tlab_size();
+
+  for (size_t size = page->free_list_largest_block(); size >= MinTLABSize; size = page->free_list_largest_block()) {
+    const size_t hole_size = align_down(MIN2(size, max_size), page->object_alignment());
+    const zaddress addr = page->take_free_list_block(hole_size);
+    if (is_null(addr)) {
+      break;
+    }
+
+    ZAllocator::eden()->register_recycled_hole(addr, hole_size);
+  }
+}
+
+ZRecyclingPolicy* ZRelocationSet::recycling_policy() {
+  return &_recycling_policy;
+}
+
+void ZRelocationSet::register_page_allocation(jlong time) {
+  Atomic::add(&_page_allocation_time, time);
+  Atomic::inc(&_npage_allocations);
+}
+
+void ZRelocationSet::register_relocated_sizes(uint type_index, ZPageAge age, const size_t* histogram) {
+  for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+    if (histogram[size_class] != 0) {
+      Atomic::add(&_relocated_sizes[type_index][static_cast<uint>(age)][size_class], histogram[size_class]);
+    }
+  }
+}
+
+void ZRelocationSet::register_recycling_failure(ZPageAge age, size_t size) {
+  const uint size_class = MIN2((uint)log2i(size), ZStatRecyclingSummary::nsize_classes - 1);
+  Atomic::inc(&_nrecycling_failures[static_cast<uint>(age)][size_class]);
+  ZStatInc(ZCounterRecyclingFailure);
+}
+
 void ZRelocationSet::register_flip_promoted(const ZArray<ZPage*>& pages) {
   ZLocker<ZLock> locker(&_promotion_lock);
   for (ZPage* const page : pages) {
@@ -214,43 +442,287 @@ void ZRelocationSet::register_in_place_relocate_promoted(ZPage* page) {
   _in_place_relocate_promoted_pages.append(page);
 }
 
-ZPage* ZRelocationSet::get_r_page(ZPageAge age, size_t index) {
-  if(index < _nrecyclable_pages[static_cast<uint>(age)-1]) {
-    return _recyclable_pages[static_cast<uint>(age)-1].at(index);
-  } else {
+ZFreeListAllocatorPool* ZRelocationSet::free_list_allocators() {
+  return &_free_list_allocators;
+}
+
+uint ZRelocationSet::recyclable_type_index(ZPageType type) {
+  assert(type == ZPageType::small || type == ZPageType::medium, "Invalid page type for recycling");
+  return type == ZPageType::small ? 0 : 1;
+}
+
+uint ZRelocationSet::recyclable_bucket_index(size_t size) {
+  assert(size > 0, "Invalid size");
+  return MIN2((uint)log2i(size), nrecyclable_buckets - 1);
+}
+
+// Called with the recycling lock held
+void ZRelocationSet::make_available(ZPage* page) {
+  const size_t largest_free_block = page->free_list_largest_block();
+  if (largest_free_block == 0) {
+    // No free blocks left
+    return;
+  }
+
+  const uint type_index = recyclable_type_index(page->type());
+  const uint age_index = static_cast<uint>(page->age()) - 1;
+  const uint bucket = recyclable_bucket_index(largest_free_block);
+  _available_pages[type_index][age_index][bucket].append({page, largest_free_block});
+}
+
+// Called with the recycling lock held
+ZPage* ZRelocationSet::claim_available_page(uint type_index, uint age_index, size_t size) {
+  ZArray<ZRecyclablePage>* const buckets = _available_pages[type_index][age_index];
+  const uint first = recyclable_bucket_index(size);
+
+  // Pages in the bucket of the size can fit the object, look
+  // for the first one that does
+  ZArray<ZRecyclablePage>* const bucket = &buckets[first];
+  for (int i = bucket->length() - 1; i >= 0; i--) {
+    const ZRecyclablePage available = bucket->at(i);
+    if (available._largest_free_block >= size) {
+      bucket->delete_at(i);
+      return available._page;
+    }
+  }
+
+  // All pages in larger buckets fit the object. Prefer the smallest
+  // bucket, to keep pages with large free blocks for large objects.
+  for (uint i = first + 1; i < nrecyclable_buckets; i++) {
+    if (buckets[i].is_nonempty()) {
+      return buckets[i].pop()._page;
+    }
+  }
+
+  return nullptr;
+}
+
+ZPage* ZRelocationSet::claim_available_pages(uint type_index, uint age_index, size_t size, ZRecyclablePageCache* cache) {
+  ZLocker<ZLock> locker(&_recycling_lock);
+
+  ZPage* const page = claim_available_page(type_index, age_index, size);
+  if (page == nullptr) {
+    // Nothing fits, and neither would the rest of the batch
     return nullptr;
   }
+
+  // Move the rest of the batch to the cache of the worker. The pages
+  // are taken from the bucket of the size and upwards, since the next
+  // objects are likely to be of similar sizes.
+  ZArray<ZRecyclablePage>* const buckets = _available_pages[type_index][age_index];
+  int batched = 1;
+  for (uint i = recyclable_bucket_index(size); i < nrecyclable_buckets && batched < RecyclablePageBatchSize; i++) {
+    while (buckets[i].is_nonempty() && batched < RecyclablePageBatchSize) {
+      cache->add(type_index, age_index, buckets[i].pop());
+      batched++;
+    }
+  }
+
+  return page;
+}
+
+ZPage* ZRelocationSet::steal_recyclable_page(uint type_index, uint age_index, size_t size, ZRecyclablePageCache* cache) {
+  ZPerWorkerIterator<ZRecyclablePageCache> iter(&_recyclable_caches);
+  for (ZRecyclablePageCache* other; iter.next(&other);) {
+    if (other == cache) {
+      continue;
+    }
+
+    ZPage* const page = other->claim(type_index, age_index, size);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+
+  return nullptr;
+}
+
+ZPage* ZRelocationSet::claim_recyclable_page(ZPageType type, ZPageAge age, size_t size) {
+  const uint type_index = recyclable_type_index(type);
+  const uint age_index = static_cast<uint>(age) - 1;
+  ZRecyclablePageCache* const cache = _recyclable_caches.addr();
+
+  // Claim from the cache of this worker
+  ZPage* page = cache->claim(type_index, age_index, size);
+  if (page != nullptr) {
+    return page;
+  }
+
+  // Claim a new batch from the shared pages
+  page = claim_available_pages(type_index, age_index, size, cache);
+  if (page != nullptr) {
+    return page;
+  }
+
+  // Steal from the caches of the other workers
+  page = steal_recyclable_page(type_index, age_index, size, cache);
+  if (page != nullptr) {
+    return page;
+  }
+
+  // Build the free lists of pending pages, until one of them fits
+  while (build_pending_free_list(type_index, age_index)) {
+    page = claim_available_pages(type_index, age_index, size, cache);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+
+  return nullptr;
+}
+
+void ZRelocationSet::return_recyclable_page(ZPage* page) {
+  // Pages are handed back to the shared pages, and not to the cache of
+  // the worker, so that all workers can use their remaining free blocks
+  ZLocker<ZLock> locker(&_recycling_lock);
+  make_available(page);
+}
+
+static const char* free_list_allocator_kind_to_string(ZFreeListAllocatorKind kind) {
+  switch (kind) {
+  case ZFreeListAllocatorKind::tlsf:
+    return "TLSF";
+  case ZFreeListAllocatorKind::binary_buddy:
+    return "Binary Buddy";
+  case ZFreeListAllocatorKind::medium_binary_buddy:
+    return "Medium Binary Buddy";
+  case ZFreeListAllocatorKind::gap_bump:
+    return "Gap Bump";
+  }
+  ShouldNotReachHere();
+  return nullptr;
 }
 
 void ZRelocationSet::print_all_r_pages() {
   log_debug(gc)("Recycled Pages:");
-  for (uint i = 0; i <= ZPageAgeMax; ++i) {
-    for(uint j = 0; j < _nrecyclable_pages[i]; ++j) {
-      ZPage* p = _recyclable_pages[i].at(j);
-      log_debug(gc)("%p:   %d / %zu / %zu / %u / %zu", 
-        (void*)p->start(), 
-        p->exhausted(), 
-        p->bytes_freed(), 
-        p->bytes_used(),
-        static_cast<uint>(p->age()),
-        p->failed_relocation_size());
+  size_t metadata_size = 0;
+
+  // Summary per free list allocator kind, used to compare the allocators
+  struct {
+    size_t npages;
+    size_t freed;
+    size_t used;
+    size_t metadata;
+    jlong  time;
+  } summary[ZFreeListAllocatorKindCount] = {};
+
+  for (uint t = 0; t < nrecyclable_types; ++t) {
+    for (uint i = 0; i <= ZPageAgeMax; ++i) {
+      for(uint j = 0; j < _nrecyclable_pages[t][i]; ++j) {
+        ZPage* p = _recyclable_pages[t][i].at(j);
+        log_debug(gc)("%p:   %d / %zu / %zu / %u / %zu / %zu", 
+          (void*)p->start(), 
+          p->exhausted(), 
+          p->bytes_freed(), 
+          p->bytes_used(),
+          static_cast<uint>(p->age()),
+          p->failed_relocation_size(),
+          p->free_list_metadata_size());
+        metadata_size += p->free_list_metadata_size();
+
+        const uint kind = static_cast<uint>(p->free_list_allocator_kind());
+        summary[kind].npages++;
+        summary[kind].freed += p->bytes_freed();
+        summary[kind].used += p->bytes_used();
+        summary[kind].metadata += p->free_list_metadata_size();
+        summary[kind].time += p->get_free_list_time();
+      }
+    }
+  }
+  log_debug(gc)("Recycled Pages Metadata: " SIZE_FORMAT "K", metadata_size / K);
+
+  for (uint kind = 0; kind < ZFreeListAllocatorKindCount; kind++) {
+    if (summary[kind].npages == 0) {
+      continue;
     }
+
+    // Hole utilization is the part of the freed holes that relocation filled
+    log_debug(gc)("Recycled Pages (%s): " SIZE_FORMAT " pages, Holes: " SIZE_FORMAT "K, Used: " SIZE_FORMAT "K (%.1f%%), Metadata: " SIZE_FORMAT "K, Free List Construction: %.3fms",
+                  free_list_allocator_kind_to_string(static_cast<ZFreeListAllocatorKind>(kind)),
+                  summary[kind].npages,
+                  summary[kind].freed / K,
+                  summary[kind].used / K,
+                  percent_of(summary[kind].used, summary[kind].freed),
+                  summary[kind].metadata / K,
+                  TimeHelper::counter_to_millis(summary[kind].time));
   }
 }
 
-void ZRelocationSet::register_recycled_pages(const ZArray<ZPage*>& pages) {
+// Called with the recycling lock held
+void ZRelocationSet::add_recyclable_page(ZPage* page) {
+  const uint type_index = recyclable_type_index(page->type());
+  _recyclable_pages[type_index][static_cast<uint>(page->age())-1].append(page);
+  _nrecyclable_pages[type_index][static_cast<uint>(page->age())-1]++;
+  make_available(page);
+}
+
+void ZRelocationSet::build_free_list(const ZPendingRecyclablePage& pending) {
+  // Promoted pages are already visible to the mutators as old pages
+  // when they are registered, so the free list is always built as if
+  // the mutators could remember fields in the page concurrently
+  pending._page->fill_page();
+  pending._page->init_free_list(&_free_list_allocators, pending._live_page, pending._min_free_block_size, true /* concurrent */);
+  ZVerify::recycled_page(pending._page, pending._live_page, pending._min_free_block_size);
+}
+
+bool ZRelocationSet::build_pending_free_list(uint type_index, uint age_index) {
+  ZPendingRecyclablePage pending;
+
+  {
+    ZLocker<ZLock> locker(&_recycling_lock);
+    if (_pending_pages[type_index][age_index].is_empty()) {
+      return false;
+    }
+
+    pending = _pending_pages[type_index][age_index].pop();
+  }
+
+  // Built outside of the lock, the page is only made available when done
+  build_free_list(pending);
+
   ZLocker<ZLock> locker(&_recycling_lock);
-  for(ZPage* const page : pages) {
-    _recyclable_pages[static_cast<uint>(page->age())-1].append(page);
-    _nrecyclable_pages[static_cast<uint>(page->age())-1]++;
+  add_recyclable_page(pending._page);
+  return true;
+}
+
+bool ZRelocationSet::build_pending_free_list() {
+  for (uint type = 0; type < nrecyclable_types; type++) {
+    for (uint age = 0; age < ZPageAgeMax + 1; age++) {
+      if (build_pending_free_list(type, age)) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void ZRelocationSet::register_recycled_pages(const ZArray<ZPendingRecyclablePage>& pages) {
+  if (!ZLazyFreeLists) {
+    // Build the free lists up front, in the registering worker
+    for (const ZPendingRecyclablePage& pending : pages) {
+      build_free_list(pending);
+    }
+  }
+
+  ZLocker<ZLock> locker(&_recycling_lock);
+  for (const ZPendingRecyclablePage& pending : pages) {
+    if (ZLazyFreeLists) {
+      const uint type_index = recyclable_type_index(pending._page->type());
+      _pending_pages[type_index][static_cast<uint>(pending._page->age())-1].append(pending);
+    } else {
+      add_recyclable_page(pending._page);
+    }
   }
 }
 
 void ZRelocationSet::reset_recycled_pages() {
-  for (uint i = 0; i <= ZPageAgeMax; ++i) {
-    for(uint j = 0; j < _nrecyclable_pages[i]; ++j) {
-      ZPage* p = _recyclable_pages[i].at(j);
-      p->reset(p->age(), ZPageResetType::FlipAging);
+  for (uint t = 0; t < nrecyclable_types; ++t) {
+    for (uint i = 0; i <= ZPageAgeMax; ++i) {
+      for(uint j = 0; j < _nrecyclable_pages[t][i]; ++j) {
+        ZPage* p = _recyclable_pages[t][i].at(j);
+        p->reset(p->age(), ZPageResetType::FlipAging);
+      }
     }
   }
 }
\ No newline at end of file
@@ -26,32 +26,83 @@
 
 #include "gc/z/zArray.hpp"
 #include "gc/z/zForwardingAllocator.hpp"
+#include "gc/z/zFreeListAllocatorPool.hpp"
 #include "gc/z/zLock.hpp"
+#include "gc/z/zPageAge.hpp"
+#include "gc/z/zPageType.hpp"
+#include "gc/z/zRecyclingPolicy.hpp"
+#include "gc/z/zStat.hpp"
+#include "gc/z/zValue.hpp"
 
 class ZForwarding;
 class ZGeneration;
 class ZPage;
 class ZPageAllocator;
+class ZRecyclablePageCache;
 class ZRelocationSetSelector;
 class ZWorkers;
 
+// A recyclable page that is available as a relocation target, together
+// with the largest free block it had when it was made available.
+struct ZRecyclablePage {
+  ZPage* _page;
+  size_t _largest_free_block;
+};
+
+// A page selected for recycling, whose free list is built from the
+// livemap of the live page when it is first needed.
+struct ZPendingRecyclablePage {
+  ZPage* _page;
+  ZPage* _live_page;
+  size_t _min_free_block_size;
+};
+
 class ZRelocationSet {
   template <bool> friend class ZRelocationSetIteratorImpl;
 
+public:
+  // Recyclable pages are registered per page type (small and medium)
+  static const uint nrecyclable_types = 2;
+
+  // Available recyclable pages are bucketed by the log2 of their largest free block
+  static const uint nrecyclable_buckets = 32;
+
+  static uint recyclable_type_index(ZPageType type);
+  static uint recyclable_bucket_index(size_t size);
+
 private:
-  ZGeneration*          _generation;
-  ZForwardingAllocator  _allocator;
-  ZForwarding**         _forwardings;
-  size_t                _nforwardings;
-  ZLock                 _promotion_lock;
-  ZLock                 _recycling_lock;
-  ZArray<ZPage*>        _flip_promoted_pages;
-  ZArray<ZPage*>        _in_place_relocate_promoted_pages;
-  ZArray<ZPage*>        _recyclable_pages[ZPageAgeMax + 1];
-  size_t                _nrecyclable_pages[ZPageAgeMax + 1];
+  ZGeneration*                     _generation;
+  ZForwardingAllocator             _allocator;
+  ZForwarding**                    _forwardings;
+  size_t                           _nforwardings;
+  ZLock                            _promotion_lock;
+  ZLock                            _recycling_lock;
+  ZArray<ZPage*>                   _flip_promoted_pages;
+  ZArray<ZPage*>                   _in_place_relocate_promoted_pages;
+  ZArray<ZPage*>                   _recyclable_pages[nrecyclable_types][ZPageAgeMax + 1];
+  size_t                           _nrecyclable_pages[nrecyclable_types][ZPageAgeMax + 1];
+  ZArray<ZRecyclablePage>          _available_pages[nrecyclable_types][ZPageAgeMax + 1][nrecyclable_buckets];
+  ZArray<ZPendingRecyclablePage>   _pending_pages[nrecyclable_types][ZPageAgeMax + 1];
+  ZPerWorker<ZRecyclablePageCache> _recyclable_caches;
+  volatile size_t                  _nrecycling_failures[ZPageAgeMax + 1][ZStatRecyclingSummary::nsize_classes];
+  volatile jlong                   _page_allocation_time;
+  volatile size_t                  _npage_allocations;
+  volatile size_t                  _relocated_sizes[nrecyclable_types][ZPageAgeMax + 1][ZStatRecyclingSummary::nsize_classes];
+  bool                             _recycling_active;
+  ZRecyclingPolicy                 _recycling_policy;
+  ZFreeListAllocatorPool           _free_list_allocators;
 
   ZWorkers* workers() const;
 
+  void add_recyclable_page(ZPage* page);
+  void make_available(ZPage* page);
+  void build_free_list(const ZPendingRecyclablePage& pending);
+  bool build_pending_free_list(uint type_index, uint age_index);
+  ZPage* claim_available_page(uint type_index, uint age_index, size_t size);
+  ZPage* claim_available_pages(uint type_index, uint age_index, size_t size, ZRecyclablePageCache* cache);
+  ZPage* steal_recyclable_page(uint type_index, uint age_index, size_t size, ZRecyclablePageCache* cache);
+  void register_recycled_holes(ZPage* page);
+
 public:
   ZRelocationSet(ZGeneration* generation);
 
@@ -63,9 +114,17 @@ public:
   void register_flip_promoted(const ZArray<ZPage*>& pages);
   void register_in_place_relocate_promoted(ZPage* page);
 
-  ZPage* get_r_page(ZPageAge age, size_t index);
+  ZFreeListAllocatorPool* free_list_allocators();
+  ZPage* claim_recyclable_page(ZPageType type, ZPageAge age, size_t size);
+  void return_recyclable_page(ZPage* page);
   void print_all_r_pages();
-  void register_recycled_pages(const ZArray<ZPage*>& pages);
+  void register_recycled_pages(const ZArray<ZPendingRecyclablePage>& pages);
+  bool build_pending_free_list();
+  ZRecyclingPolicy* recycling_policy();
+  void register_recycling_failure(ZPageAge age, size_t size);
+  void register_page_allocation(jlong time);
+  void register_relocated_sizes(uint type_index, ZPageAge age, const size_t* histogram);
+  void release_recycled_pages();
   void reset_recycled_pages();
 };
 
@@ -26,6 +26,8 @@
 #include "gc/z/zArray.inline.hpp"
 #include "gc/z/zForwarding.inline.hpp"
 #include "gc/z/zPage.inline.hpp"
+#include "gc/z/zRecyclingPolicy.hpp"
+#include "gc/z/zRelocate.hpp"
 #include "gc/z/zRelocationSetSelector.inline.hpp"
 #include "jfr/jfrEvents.hpp"
 #include "logging/log.hpp"
@@ -39,19 +41,23 @@ ZRelocationSetSelectorGroupStats::ZRelocationSetSelectorGroupStats()
     _live(0),
     _empty(0),
     _npages_selected(0),
-    _relocate(0) {}
+    _relocate(0),
+    _npages_recycled(0),
+    _recycled(0) {}
 
 ZRelocationSetSelectorGroup::ZRelocationSetSelectorGroup(const char* name,
                                                          ZPageType page_type,
                                                          size_t page_size,
                                                          size_t object_size_limit,
-                                                         double fragmentation_limit)
+                                                         double fragmentation_limit,
+                                                         const ZRecyclingPolicy* recycling_policy)
   : _name(name),
     _page_type(page_type),
     _page_size(page_size),
     _object_size_limit(object_size_limit),
     _fragmentation_limit(fragmentation_limit),
     _page_fragmentation_limit(page_size * (fragmentation_limit / 100)),
+    _recycling_policy(recycling_policy),
     _live_pages(),
     _not_selected_pages(),
     _forwarding_entries(0),
@@ -109,6 +115,17 @@ void ZRelocationSetSelectorGroup::semi_sort() {
   _live_pages.swap(&sorted_live_pages);
 }
 
+bool ZRelocationSetSelectorGroup::should_keep_as_target(ZPage* page) {
+  if (_recycling_policy == nullptr) {
+    // Pages are selected from fragmentation alone
+    return false;
+  }
+
+  // The tenuring threshold of this cycle is selected after the relocation
+  // set, so the age the page would be flipped to is an estimate
+  return _recycling_policy->should_keep_as_target(page, ZRelocate::compute_to_age(page->age()));
+}
+
 void ZRelocationSetSelectorGroup::select_inner() {
   // Calculate the number of pages to relocate by successively including pages in
   // a candidate relocation set and calculate the maximum space requirement for
@@ -160,24 +177,60 @@ void ZRelocationSetSelectorGroup::select_inner() {
                          int(page_live_bytes * 100 / page->size()));
   }
 
-  // Finalize selection
-  for (int i = selected_from; i < _live_pages.length(); i++) {
+  // Keep the selected pages whose holes are expected to be worth more as
+  // recycling targets than the space reclaimed by relocating them. Kept
+  // pages are not selected, and are recycled when they are flipped. The
+  // selected pages are counted here, since the pages rejected before the
+  // selection moved past them are selected too.
+  int nkept = 0;
+  size_t recycled[ZPageAgeMax + 1] = { 0 };
+  size_t npages_recycled[ZPageAgeMax + 1] = { 0 };
+  for (uint i = 0; i <= ZPageAgeMax; i++) {
+    selected_live_bytes[i] = 0;
+    npages_selected[i] = 0;
+  }
+
+  for (int i = 0; i < selected_from; i++) {
     ZPage* const page = _live_pages.at(i);
-    if (page->is_young()) {
+    const uint age = static_cast<uint>(page->age());
+
+    if (should_keep_as_target(page)) {
+      const ZPageAge to_age = ZRelocate::compute_to_age(page->age());
       _not_selected_pages.append(page);
+      selected_forwarding_entries -= ZForwarding::nentries(page);
+      recycled[age] += (size_t)(_recycling_policy->hole_utilization(to_age) * (page->size() - page->live_bytes()));
+      npages_recycled[age] += 1;
+      continue;
     }
+
+    selected_live_bytes[age] += page->live_bytes();
+    npages_selected[age] += 1;
+    _live_pages.at_put(nkept++, page);
+  }
+
+  // Finalize selection
+  for (int i = selected_from; i < _live_pages.length(); i++) {
+    ZPage* const page = _live_pages.at(i);
+    _not_selected_pages.append(page);
   }
-  _live_pages.trunc_to(selected_from);
+  _live_pages.trunc_to(nkept);
   _forwarding_entries = selected_forwarding_entries;
 
   // Update statistics
+  size_t relocate = 0;
   for (uint i = 0; i <= ZPageAgeMax; ++i) {
     _stats[i]._relocate = selected_live_bytes[i];
     _stats[i]._npages_selected = npages_selected[i];
+    _stats[i]._npages_recycled = npages_recycled[i];
+    _stats[i]._recycled = recycled[i];
+    relocate += selected_live_bytes[i];
   }
 
-  log_debug(gc, reloc)("Relocation Set (%s Pages): %d->%d, %d skipped, " SIZE_FORMAT " forwarding entries",
-                       _name, selected_from, selected_to, npages - selected_from, selected_forwarding_entries);
+  // The pages needed by the final relocation set, without the kept pages
+  const int to = ceil((double)(relocate) / (double)(_page_size - _object_size_limit));
+
+  log_debug(gc, reloc)("Relocation Set (%s Pages): %d->%d, %d skipped, %d kept as recycling targets, " SIZE_FORMAT " forwarding entries",
+                       _name, nkept, to, npages - selected_from, selected_from - nkept, selected_forwarding_entries);
 }
 
 void ZRelocationSetSelectorGroup::select() {
@@ -211,10 +264,10 @@ void ZRelocationSetSelectorGroup::select() {
   event.commit((u8)_page_type, s._npages_candidates, s._total, s._empty, s._npages_selected, s._relocate);
 }
 
-ZRelocationSetSelector::ZRelocationSetSelector(double fragmentation_limit)
-  : _small("Small", ZPageType::small, ZPageSizeSmall, ZObjectSizeLimitSmall, fragmentation_limit),
-    _medium("Medium", ZPageType::medium, ZPageSizeMedium, ZObjectSizeLimitMedium, fragmentation_limit),
-    _large("Large", ZPageType::large, 0 /* page_size */, 0 /* object_size_limit */, fragmentation_limit),
+ZRelocationSetSelector::ZRelocationSetSelector(double fragmentation_limit, const ZRecyclingPolicy* recycling_policy)
+  : _small("Small", ZPageType::small, ZPageSizeSmall, ZObjectSizeLimitSmall, fragmentation_limit, recycling_policy),
+    _medium("Medium", ZPageType::medium, ZPageSizeMedium, ZObjectSizeLimitMedium, fragmentation_limit, recycling_policy),
+    _large("Large", ZPageType::large, 0 /* page_size */, 0 /* object_size_limit */, fragmentation_limit, recycling_policy),
     _empty_pages() {}
 
 void ZRelocationSetSelector::select() {
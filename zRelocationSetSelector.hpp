@@ -31,6 +31,7 @@
 #include "memory/allocation.hpp"
 
 class ZPage;
+class ZRecyclingPolicy;
 
 class ZRelocationSetSelectorGroupStats {
   friend class ZRelocationSetSelectorGroup;
@@ -46,6 +47,11 @@ private:
   size_t _npages_selected;
   size_t _relocate;
 
+  // Pages kept as recycling targets, and the expected bytes relocated
+  // into their holes instead of into new pages
+  size_t _npages_recycled;
+  size_t _recycled;
+
 public:
   ZRelocationSetSelectorGroupStats();
 
@@ -56,6 +62,9 @@ public:
 
   size_t npages_selected() const;
   size_t relocate() const;
+
+  size_t npages_recycled() const;
+  size_t recycled() const;
 };
 
 class ZRelocationSetSelectorStats {
@@ -84,6 +93,7 @@ private:
   const size_t                     _object_size_limit;
   const double                     _fragmentation_limit;
   const size_t                     _page_fragmentation_limit;
+  const ZRecyclingPolicy* const    _recycling_policy;
   ZArray<ZPage*>                   _live_pages;
   ZArray<ZPage*>                   _not_selected_pages;
   size_t                           _forwarding_entries;
@@ -93,6 +103,7 @@ private:
   bool is_disabled();
   bool is_selectable();
   void semi_sort();
+  bool should_keep_as_target(ZPage* page);
   void select_inner();
 
 public:
@@ -100,7 +111,8 @@ public:
                               ZPageType page_type,
                               size_t page_size,
                               size_t object_size_limit,
-                              double fragmentation_limit);
+                              double fragmentation_limit,
+                              const ZRecyclingPolicy* recycling_policy);
 
   void register_live_page(ZPage* page);
   void register_empty_page(ZPage* page);
@@ -126,7 +138,7 @@ private:
   size_t relocate() const;
 
 public:
-  ZRelocationSetSelector(double fragmentation_limit);
+  ZRelocationSetSelector(double fragmentation_limit, const ZRecyclingPolicy* recycling_policy);
 
   void register_live_page(ZPage* page);
   void register_empty_page(ZPage* page);
@@ -53,6 +53,14 @@ inline size_t ZRelocationSetSelectorGroupStats::relocate() const {
   return _relocate;
 }
 
+inline size_t ZRelocationSetSelectorGroupStats::npages_recycled() const {
+  return _npages_recycled;
+}
+
+inline size_t ZRelocationSetSelectorGroupStats::recycled() const {
+  return _recycled;
+}
+
 inline bool ZRelocationSetSelectorStats::has_relocatable_pages() const {
   return _has_relocatable_pages;
 }
@@ -83,8 +91,9 @@ inline void ZRelocationSetSelectorGroup::register_live_page(ZPage* page) {
     //   _live_pages.append(page);
     // }
     _live_pages.append(page);
-  } else if (page->is_young()) {
+  } else {
     // _found_age[static_cast<uint>(page->age())] = true;
+    // Young pages are flip aged, and sparse old pages can be recycled
     _not_selected_pages.append(page);
   }
 
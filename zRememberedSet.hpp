@@ -122,6 +122,8 @@ public:
   bool set_current(uintptr_t offset);
   void unset_non_par_current(uintptr_t offset);
   void unset_range_non_par_current(uintptr_t offset, size_t size);
+  void unset_range_par_current(uintptr_t offset, size_t size);
+  void unset_range_par_previous(uintptr_t offset, size_t size);
 
   // Visit all set offsets.
   template <typename Function /* void(uintptr_t offset) */>
@@ -84,6 +84,18 @@ inline void ZRememberedSet::unset_range_non_par_current(uintptr_t offset, size_t
   current()->clear_range(start_index, end_index);
 }
 
+inline void ZRememberedSet::unset_range_par_current(uintptr_t offset, size_t size) {
+  const BitMap::idx_t start_index = to_index(offset);
+  const BitMap::idx_t end_index = to_index(offset + size);
+  current()->par_clear_range(start_index, end_index, BitMap::unknown_range);
+}
+
+inline void ZRememberedSet::unset_range_par_previous(uintptr_t offset, size_t size) {
+  const BitMap::idx_t start_index = to_index(offset);
+  const BitMap::idx_t end_index = to_index(offset + size);
+  previous()->par_clear_range(start_index, end_index, BitMap::unknown_range);
+}
+
 template <typename Function>
 void ZRememberedSet::iterate_bitmap(Function function, CHeapBitMap* bitmap) {
   bitmap->iterate([&](BitMap::idx_t index) {
@@ -44,6 +44,7 @@
 #include "runtime/timer.hpp"
 #include "utilities/align.hpp"
 #include "utilities/debug.hpp"
+#include "utilities/ostream.hpp"
 #include "utilities/ticks.hpp"
 
 #define ZSIZE_FMT                       SIZE_FORMAT "M(%.0f%%)"
@@ -736,6 +737,8 @@ void ZStatPhaseGeneration::register_end(ConcurrentGCTimer* timer, const Ticks& s
   if (generation->is_young()) {
     generation->stat_relocation()->print_age_table();
   }
+  generation->stat_relocation()->print_recycling();
+  generation->stat_relocation()->print_relocated_sizes();
 
   generation->stat_heap()->print(generation);
 
@@ -1465,19 +1468,41 @@ ZStatRelocation::ZStatRelocation()
     _small_selected(),
     _small_in_place_count(),
     _medium_selected(),
-    _medium_in_place_count() {}
+    _medium_in_place_count(),
+    _medium_recycled_count(),
+    _small_aggregated_count(),
+    _recycling(),
+    _relocated_sizes() {}
 
 void ZStatRelocation::at_select_relocation_set(const ZRelocationSetSelectorStats& selector_stats) {
   _selector_stats = selector_stats;
+
+  // Pages are recycled after the selection, clear the previous cycle
+  for (uint i = 0; i <= ZPageAgeMax; ++i) {
+    _recycling[i] = {};
+  }
 }
 
 void ZStatRelocation::at_install_relocation_set(size_t forwarding_usage) {
   _forwarding_usage = forwarding_usage;
 }
 
-void ZStatRelocation::at_relocate_end(size_t small_in_place_count, size_t medium_in_place_count) {
+void ZStatRelocation::at_relocate_end(size_t small_in_place_count, size_t medium_in_place_count, size_t medium_recycled_count, size_t small_aggregated_count) {
   _small_in_place_count = small_in_place_count;
   _medium_in_place_count = medium_in_place_count;
+  _medium_recycled_count = medium_recycled_count;
+  _small_aggregated_count = small_aggregated_count;
+}
+
+void ZStatRelocation::at_release_recycled_pages(ZPageAge age, const ZStatRecyclingSummary& summary) {
+  _recycling[static_cast<uint>(age)] = summary;
+}
+
+void ZStatRelocation::at_relocated_sizes(ZPageType type, ZPageAge age, const size_t* histogram) {
+  const uint type_index = (type == ZPageType::small) ? 0 : 1;
+  for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+    _relocated_sizes[type_index][static_cast<uint>(age)][size_class] = histogram[size_class];
+  }
 }
 
 void ZStatRelocation::print_page_summary() {
@@ -1499,6 +1524,8 @@ void ZStatRelocation::print_page_summary() {
     summary.empty += stats.empty();
     summary.npages_selected += stats.npages_selected();
     summary.relocate += stats.relocate();
+    summary.npages_recycled += stats.npages_recycled();
+    summary.recycled += stats.recycled();
   };
 
   for (uint i = 0; i <= ZPageAgeMax; ++i) {
@@ -1538,6 +1565,28 @@ void ZStatRelocation::print_page_summary() {
   }
   print_summary("Large", large_summary, 0 /* in_place_count */);
 
+  if (ZPageSizeMedium != 0 && ZRecycleMediumPages) {
+    lt.print("Medium Objects Relocated Into Recycled Pages: " SIZE_FORMAT, _medium_recycled_count);
+  }
+
+  if (ZRecyclingAwareSelection) {
+    // The expected savings are the new pages that the used holes of the
+    // kept pages replace
+    auto print_recycling_targets = [&](const char* name, ZStatRelocationSummary& summary, size_t page_size) {
+      lt.print("%s Pages Kept As Recycling Targets: " SIZE_FORMAT ", Expected Pages Saved: " SIZE_FORMAT " (" SIZE_FORMAT "M)",
+               name, summary.npages_recycled, summary.recycled / page_size, summary.recycled / M);
+    };
+
+    print_recycling_targets("Small", small_summary, ZPageSizeSmall);
+    if (ZPageSizeMedium != 0 && ZRecycleMediumPages) {
+      print_recycling_targets("Medium", medium_summary, ZPageSizeMedium);
+    }
+  }
+
+  if (ZAggregateFreeLists) {
+    lt.print("Small Objects Relocated After Free List Aggregation: " SIZE_FORMAT, _small_aggregated_count);
+  }
+
   lt.print("Forwarding Usage: " SIZE_FORMAT "M", _forwarding_usage / M);
 }
 
@@ -1617,6 +1666,115 @@ void ZStatRelocation::print_age_table() {
   }
 }
 
+void ZStatRelocation::print_recycling() {
+  LogTarget(Info, gc, reloc) lt;
+  if (!lt.is_enabled()) {
+    // Logging not enabled
+    return;
+  }
+
+  bool has_recycled_pages = false;
+  for (uint i = 0; i <= ZPageAgeMax; ++i) {
+    has_recycled_pages |= _recycling[i].npages != 0;
+  }
+
+  if (!has_recycled_pages) {
+    // Nothing to log
+    return;
+  }
+
+  ZStatTablePrinter recycling_table(11, 12);
+  lt.print("Recycling:");
+  lt.print("%s", recycling_table()
+           .fill()
+           .right("Pages")
+           .right("Offered")
+           .right("Consumed")
+           .right("Exhausted")
+           .right("Avoided")
+           .right("Free Lists")
+           .end());
+
+  for (uint i = 0; i <= ZPageAgeMax; ++i) {
+    const ZStatRecyclingSummary& summary = _recycling[i];
+    if (summary.npages == 0) {
+      continue;
+    }
+
+    const ZPageAge age = static_cast<ZPageAge>(i);
+    FormatBuffer<> age_str("");
+    if (age == ZPageAge::old) {
+      age_str.append("Old");
+    } else {
+      age_str.append("Survivor %d", i);
+    }
+
+    lt.print("%s", recycling_table()
+             .left("%s", age_str.buffer())
+             .right(SIZE_FORMAT, summary.npages)
+             .right(SIZE_FORMAT "K", summary.offered / K)
+             .right(SIZE_FORMAT "K", summary.consumed / K)
+             .right(SIZE_FORMAT, summary.nexhausted)
+             .right("%.0f", summary.npages_avoided)
+             .right("%.3fms", TimeHelper::counter_to_millis(summary.free_list_time))
+             .end());
+
+    // Failed free list allocations, by size class
+    stringStream failures;
+    for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+      if (summary.nfailures[size_class] != 0) {
+        failures.print(" " SIZE_FORMAT "B: " SIZE_FORMAT, (size_t)1 << size_class, summary.nfailures[size_class]);
+      }
+    }
+
+    if (failures.size() > 0) {
+      lt.print("%s Allocation Failures:%s", age_str.buffer(), failures.base());
+    }
+  }
+}
+
+void ZStatRelocation::print_relocated_sizes() {
+  LogTarget(Debug, gc, reloc) lt;
+  if (!lt.is_enabled()) {
+    // Logging not enabled
+    return;
+  }
+
+  bool printed_header = false;
+  for (uint type_index = 0; type_index < 2; type_index++) {
+    for (uint i = 0; i <= ZPageAgeMax; ++i) {
+      const size_t* const histogram = _relocated_sizes[type_index][i];
+
+      // Relocated objects, by size class
+      stringStream sizes;
+      for (uint size_class = 0; size_class < ZStatRecyclingSummary::nsize_classes; size_class++) {
+        if (histogram[size_class] != 0) {
+          sizes.print(" " SIZE_FORMAT "B: " SIZE_FORMAT, (size_t)1 << size_class, histogram[size_class]);
+        }
+      }
+
+      if (sizes.size() == 0) {
+        continue;
+      }
+
+      if (!printed_header) {
+        lt.print("Relocated Object Sizes:");
+        printed_header = true;
+      }
+
+      const ZPageAge age = static_cast<ZPageAge>(i);
+      FormatBuffer<> age_str("");
+      if (age == ZPageAge::old) {
+        age_str.append("Old");
+      } else {
+        age_str.append("Survivor %d", i);
+      }
+
+      lt.print("%s %s:%s", type_index == 0 ? "Small" : "Medium", age_str.buffer(), sizes.base());
+    }
+  }
+}
+
 //
 // Stat nmethods
 //
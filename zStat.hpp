@@ -517,6 +517,22 @@ struct ZStatRelocationSummary {
   size_t empty;
   size_t npages_selected;
   size_t relocate;
+  size_t npages_recycled;
+  size_t recycled;
+};
+
+// Recycling outcome of the pages of one age
+struct ZStatRecyclingSummary {
+  // Failed free list allocations are counted per log2 of the object size
+  static const uint nsize_classes = 32;
+
+  size_t npages;
+  size_t offered;
+  size_t consumed;
+  size_t nexhausted;
+  double npages_avoided;
+  jlong  free_list_time;
+  size_t nfailures[nsize_classes];
 };
 
 //
@@ -530,6 +546,10 @@ private:
   size_t                      _small_in_place_count;
   size_t                      _medium_selected;
   size_t                      _medium_in_place_count;
+  size_t                      _medium_recycled_count;
+  size_t                      _small_aggregated_count;
+  ZStatRecyclingSummary       _recycling[ZPageAgeMax + 1];
+  size_t                      _relocated_sizes[2][ZPageAgeMax + 1][ZStatRecyclingSummary::nsize_classes];
 
   void print(const char* name,
              ZStatRelocationSummary selector_group,
@@ -540,10 +560,14 @@ public:
 
   void at_select_relocation_set(const ZRelocationSetSelectorStats& selector_stats);
   void at_install_relocation_set(size_t forwarding_usage);
-  void at_relocate_end(size_t small_in_place_count, size_t medium_in_place_count);
+  void at_relocate_end(size_t small_in_place_count, size_t medium_in_place_count, size_t medium_recycled_count, size_t small_aggregated_count);
+  void at_release_recycled_pages(ZPageAge age, const ZStatRecyclingSummary& summary);
+  void at_relocated_sizes(ZPageType type, ZPageAge age, const size_t* histogram);
 
   void print_page_summary();
   void print_age_table();
+  void print_recycling();
+  void print_relocated_sizes();
 };
 
 //
@@ -30,6 +30,7 @@
 #include "gc/z/zGenerationId.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zNMethod.hpp"
+#include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPageAllocator.hpp"
 #include "gc/z/zResurrection.hpp"
 #include "gc/z/zRootsIterator.hpp"
@@ -37,6 +38,8 @@
 #include "gc/z/zStoreBarrierBuffer.inline.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zVerify.hpp"
+#include "logging/log.hpp"
+#include "logging/logStream.hpp"
 #include "memory/iterator.inline.hpp"
 #include "memory/resourceArea.hpp"
 #include "oops/oop.hpp"
@@ -777,3 +780,30 @@ void ZVerify::after_scan(ZForwarding* forwarding) {
 
   after_relocation_internal(forwarding);
 }
+
+void ZVerify::recycled_page(ZPage* page, ZPage* live_page, size_t min_free_block_size) {
+  if (!ZVerifyRecycledPages) {
+    return;
+  }
+
+  page->verify_free_list(live_page, min_free_block_size);
+}
+
+void ZVerify::recycled_pages(const ZArray<ZPage*>& pages) {
+  LogTarget(Trace, gc, reloc) log;
+  if (!ZVerifyRecycledPages && !log.is_enabled()) {
+    return;
+  }
+
+  LogStream ls(log);
+
+  for (ZPage* const page : pages) {
+    if (ZVerifyRecycledPages) {
+      page->verify_free_list_after_relocation();
+    }
+
+    if (log.is_enabled()) {
+      page->print_free_list_fragmentation(&ls);
+    }
+  }
+}
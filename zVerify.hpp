@@ -24,10 +24,12 @@
 #ifndef SHARE_GC_Z_ZVERIFY_HPP
 #define SHARE_GC_Z_ZVERIFY_HPP
 
+#include "gc/z/zArray.hpp"
 #include "memory/allStatic.hpp"
 
 class frame;
 class ZForwarding;
+class ZPage;
 class ZPageAllocator;
 
 NOT_DEBUG(inline) void z_verify_safepoints_are_blocked() NOT_DEBUG_RETURN;
@@ -51,6 +53,9 @@ public:
   static void after_relocation(ZForwarding* forwarding);
   static void after_scan(ZForwarding* forwarding);
 
+  static void recycled_page(ZPage* page, ZPage* live_page, size_t min_free_block_size);
+  static void recycled_pages(const ZArray<ZPage*>& pages);
+
   static void on_color_flip();
 };
 
@@ -64,12 +64,72 @@
   product(bool, ZVerifyRemembered, trueInDebug, DIAGNOSTIC,                 \
           "Verify remembered sets")                                         \
                                                                             \
+  product(bool, ZVerifyRecycledPages, false, DIAGNOSTIC,                    \
+          "Verify the free lists of recycled pages against their livemaps") \
+                                                                            \
   develop(bool, ZVerifyOops, false,                                         \
           "Verify accessed oops")                                           \
                                                                             \
   product(bool, ZUseBuddyAllocator, false, DIAGNOSTIC,                      \
           "Choose free list allocator")                                     \
                                                                             \
+  product(bool, ZLiveMapSummary, false, DIAGNOSTIC,                         \
+          "Keep a summary of the non-empty words of each livemap, so that " \
+          "iterating the live objects of sparse pages skips the empty "     \
+          "words")                                                          \
+                                                                            \
+  product(bool, ZUseGapBumpAllocator, false, DIAGNOSTIC,                    \
+          "Relocate into the gaps of recycled small pages with a bump "     \
+          "pointer instead of a free list allocator. Takes precedence "     \
+          "over ZUseBuddyAllocator")                                        \
+                                                                            \
+  product(size_t, ZRecycledLocalityWindowSize, 0, DIAGNOSTIC,               \
+          "Size of the window that relocation carves from the free list "   \
+          "of a small recycled page and fills in address order, so that "   \
+          "objects relocated together stay adjacent. 0 allocates each "     \
+          "object from the free list")                                      \
+          range(0, 64 * K)                                                  \
+                                                                            \
+  product(bool, ZLazyFreeLists, true, DIAGNOSTIC,                           \
+          "Build the free lists of recycled pages when relocation first "   \
+          "needs them, instead of when the pages are selected for "         \
+          "recycling")                                                      \
+                                                                            \
+  product(bool, ZRecyclingAwareSelection, false, DIAGNOSTIC,                \
+          "Keep pages that would be relocated as recycling targets, when "  \
+          "the hole utilization and free list construction time of the "    \
+          "last cycles make that cheaper than relocating them")             \
+                                                                            \
+  product(bool, ZAllocateTLABsInRecycledPages, false, DIAGNOSTIC,           \
+          "Carve TLABs from the holes that relocation left in recycled "    \
+          "young pages, until the next young collection starts marking")    \
+                                                                            \
+  product(bool, ZRecycleMediumPages, false, DIAGNOSTIC,                     \
+          "Recycle sparse medium pages through free lists. Medium pages "   \
+          "always use a binary buddy allocator")                            \
+                                                                            \
+  product(bool, ZRecycleOldPages, false, DIAGNOSTIC,                        \
+          "Recycle sparse old pages through free lists, as promotion "      \
+          "targets in young collections and as relocation targets in "      \
+          "old collections")                                                \
+                                                                            \
+  product(bool, ZPrefetchRelocation, true, DIAGNOSTIC,                      \
+          "Prefetch the next from-object, and the memory following an "     \
+          "object relocated into a recycled page, during relocation")       \
+                                                                            \
+  product(uint, ZRelocationBatchSize, 8, DIAGNOSTIC,                        \
+          "Number of live objects relocated as a batch, whose free list "   \
+          "blocks in a small recycled page are allocated together")         \
+          range(1, 16 /* ZPage::free_list_batch_max */)                     \
+                                                                            \
+  product(bool, ZAggregateFreeLists, true, DIAGNOSTIC,                      \
+          "Coalesce the free list of a small recycled page when an "        \
+          "allocation fails, although its free bytes would fit it")         \
+                                                                            \
+  product(bool, ZAggregateRetiredFreeLists, false, DIAGNOSTIC,              \
+          "Coalesce the free list of a small recycled page when it is "     \
+          "handed back, before other relocation workers can claim it")      \
+                                                                            \
   product(int, ZTenuringThreshold, -1, DIAGNOSTIC,                          \
           "Young generation tenuring threshold, -1 for dynamic computation")\
           range(-1, static_cast<int>(ZPageAgeMax))                          \
@@ -84,6 +144,12 @@
   product(double, ZRecycleMaximumLive, 1, DIAGNOSTIC,"")                    \
           range(0, 1 /* 100% */)                                            \
                                                                             \
+  product(bool, ZAdaptiveRecycling, false, DIAGNOSTIC,                      \
+          "Adjust the maximum live fraction and the minimum free block "    \
+          "size of recycled pages per age, from the recycling outcome of "  \
+          "the last cycles. ZRecycleMaximumLive and ZMinFreeBlockSize "     \
+          "are used as bounds")                                             \
+                                                                            \
   develop(size_t, ZForceDiscontiguousHeapReservations, 0,                   \
           "The gc will attempt to split the heap reservation into this "    \
           "many reservations, subject to available virtual address space "  \